@@ -191,6 +191,44 @@ namespace fs
 		// Do notning
 	}
 
+	u64 file_base::read_at(u64 offset, void* buffer, u64 size)
+	{
+		const u64 old_pos = seek(0, seek_cur);
+
+		if (seek(offset, seek_set) != offset)
+		{
+			return 0;
+		}
+
+		const u64 result = read(buffer, size);
+		seek(old_pos, seek_set);
+		return result;
+	}
+
+	u64 file_base::write_at(u64 offset, const void* buffer, u64 size)
+	{
+		const u64 old_pos = seek(0, seek_cur);
+
+		if (seek(offset, seek_set) != offset)
+		{
+			return 0;
+		}
+
+		const u64 result = write(buffer, size);
+		seek(old_pos, seek_set);
+		return result;
+	}
+
+	std::unique_ptr<view_base> file_base::map()
+	{
+		g_tls_error = error::inval;
+		return nullptr;
+	}
+
+	view_base::~view_base()
+	{
+	}
+
 	dir_base::~dir_base()
 	{
 	}
@@ -838,10 +876,41 @@ fs::file::file(const std::string& path, bs_t<open_mode> mode)
 		return;
 	}
 
+	class windows_view final : public view_base
+	{
+		const u8* const m_ptr;
+		const u64 m_size;
+
+	public:
+		windows_view(const u8* ptr, u64 size)
+			: m_ptr(ptr)
+			, m_size(size)
+		{
+		}
+
+		~windows_view() override
+		{
+			UnmapViewOfFile(m_ptr);
+		}
+
+		const u8* data() override
+		{
+			return m_ptr;
+		}
+
+		u64 size() override
+		{
+			return m_size;
+		}
+	};
+
 	class windows_file final : public file_base, public get_native_handle
 	{
 		const HANDLE m_handle;
 
+		// Positioned I/O moves the file pointer of a synchronous handle, it's restored under this lock
+		shared_mutex m_pos_mutex;
+
 	public:
 		windows_file(HANDLE handle)
 			: m_handle(handle)
@@ -938,6 +1007,88 @@ fs::file::file(const std::string& path, bs_t<open_mode> mode)
 			return size.QuadPart;
 		}
 
+		u64 read_at(u64 offset, void* buffer, u64 count) override
+		{
+			// TODO (call ReadFile multiple times if count is too big)
+			const int size = narrow<int>(count, "file::read_at" HERE);
+
+			OVERLAPPED ovl{};
+			ovl.Offset = static_cast<DWORD>(offset);
+			ovl.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+			writer_lock lock(m_pos_mutex);
+
+			LARGE_INTEGER pos{};
+			verify("file::read_at" HERE), SetFilePointerEx(m_handle, pos, &pos, FILE_CURRENT);
+
+			DWORD nread;
+			const bool ok = ReadFile(m_handle, buffer, size, &nread, &ovl) != FALSE;
+			const DWORD err = GetLastError();
+
+			verify("file::read_at" HERE), SetFilePointerEx(m_handle, pos, NULL, FILE_BEGIN);
+
+			if (!ok)
+			{
+				verify("file::read_at" HERE), err == ERROR_HANDLE_EOF;
+				return 0;
+			}
+
+			return nread;
+		}
+
+		u64 write_at(u64 offset, const void* buffer, u64 count) override
+		{
+			// TODO (call WriteFile multiple times if count is too big)
+			const int size = narrow<int>(count, "file::write_at" HERE);
+
+			OVERLAPPED ovl{};
+			ovl.Offset = static_cast<DWORD>(offset);
+			ovl.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+			writer_lock lock(m_pos_mutex);
+
+			LARGE_INTEGER pos{};
+			verify("file::write_at" HERE), SetFilePointerEx(m_handle, pos, &pos, FILE_CURRENT);
+
+			DWORD nwritten;
+			verify("file::write_at" HERE), WriteFile(m_handle, buffer, size, &nwritten, &ovl);
+			verify("file::write_at" HERE), SetFilePointerEx(m_handle, pos, NULL, FILE_BEGIN);
+
+			return nwritten;
+		}
+
+		std::unique_ptr<view_base> map() override
+		{
+			const u64 size = this->size();
+
+			if (!size)
+			{
+				g_tls_error = fs::error::inval;
+				return nullptr;
+			}
+
+			const HANDLE mapping = CreateFileMappingW(m_handle, NULL, PAGE_READONLY, 0, 0, NULL);
+
+			if (!mapping)
+			{
+				g_tls_error = to_error(GetLastError());
+				return nullptr;
+			}
+
+			// The view keeps the mapping object alive
+			const auto ptr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			const DWORD err = GetLastError();
+			CloseHandle(mapping);
+
+			if (!ptr)
+			{
+				g_tls_error = to_error(err);
+				return nullptr;
+			}
+
+			return std::make_unique<windows_view>(static_cast<const u8*>(ptr), size);
+		}
+
 		native_handle get() override
 		{
 			return m_handle;
@@ -985,6 +1136,34 @@ fs::file::file(const std::string& path, bs_t<open_mode> mode)
 		::ftruncate(fd, 0);
 	}
 
+	class unix_view final : public view_base
+	{
+		const u8* const m_ptr;
+		const u64 m_size;
+
+	public:
+		unix_view(const u8* ptr, u64 size)
+			: m_ptr(ptr)
+			, m_size(size)
+		{
+		}
+
+		~unix_view() override
+		{
+			::munmap(const_cast<u8*>(m_ptr), m_size);
+		}
+
+		const u8* data() override
+		{
+			return m_ptr;
+		}
+
+		u64 size() override
+		{
+			return m_size;
+		}
+	};
+
 	class unix_file final : public file_base, public get_native_handle
 	{
 		const int m_fd;
@@ -1075,6 +1254,43 @@ fs::file::file(const std::string& path, bs_t<open_mode> mode)
 			return file_info.st_size;
 		}
 
+		u64 read_at(u64 offset, void* buffer, u64 count) override
+		{
+			const auto result = ::pread(m_fd, buffer, count, offset);
+			verify("file::read_at" HERE), result != -1;
+
+			return result;
+		}
+
+		u64 write_at(u64 offset, const void* buffer, u64 count) override
+		{
+			const auto result = ::pwrite(m_fd, buffer, count, offset);
+			verify("file::write_at" HERE), result != -1;
+
+			return result;
+		}
+
+		std::unique_ptr<view_base> map() override
+		{
+			const u64 size = this->size();
+
+			if (!size)
+			{
+				g_tls_error = fs::error::inval;
+				return nullptr;
+			}
+
+			const auto ptr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+
+			if (ptr == MAP_FAILED)
+			{
+				g_tls_error = to_error(errno);
+				return nullptr;
+			}
+
+			return std::make_unique<unix_view>(static_cast<const u8*>(ptr), size);
+		}
+
 		native_handle get() override
 		{
 			return m_fd;
@@ -1149,6 +1365,47 @@ fs::file::file(const void* ptr, std::size_t size)
 		{
 			return m_size;
 		}
+
+		u64 read_at(u64 offset, void* buffer, u64 count) override
+		{
+			if (offset < m_size)
+			{
+				const u64 result = std::min<u64>(count, m_size - offset);
+				std::memcpy(buffer, m_ptr + offset, result);
+				return result;
+			}
+
+			return 0;
+		}
+
+		std::unique_ptr<view_base> map() override
+		{
+			class memory_view final : public view_base
+			{
+				const u8* const m_ptr;
+				const u64 m_size;
+
+			public:
+				memory_view(const u8* ptr, u64 size)
+					: m_ptr(ptr)
+					, m_size(size)
+				{
+				}
+
+				const u8* data() override
+				{
+					return m_ptr;
+				}
+
+				u64 size() override
+				{
+					return m_size;
+				}
+			};
+
+			// Refers to the same memory (not owned)
+			return std::make_unique<memory_view>(reinterpret_cast<const u8*>(m_ptr), m_size);
+		}
 	};
 
 	m_file = std::make_unique<memory_stream>(ptr, size);
@@ -1168,6 +1425,158 @@ fs::native_handle fs::file::get_handle() const
 #endif
 }
 
+void fs::file::set_read_buffer(std::size_t size)
+{
+	if (!m_file) xnull();
+
+	if (!size)
+	{
+		return;
+	}
+
+	class buffered_file final : public file_base, public get_native_handle
+	{
+		const std::unique_ptr<file_base> m_file;
+
+		const std::unique_ptr<u8[]> m_buf;
+		const u64 m_buf_max;
+
+		u64 m_buf_pos = 0; // File offset of the buffered data
+		u64 m_buf_size = 0; // Amount of the buffered data
+		u64 m_pos;
+
+	public:
+		buffered_file(std::unique_ptr<file_base>&& file, std::size_t size)
+			: m_file(std::move(file))
+			, m_buf(new u8[size])
+			, m_buf_max(size)
+			, m_pos(m_file->seek(0, seek_cur))
+		{
+		}
+
+		stat_t stat() override
+		{
+			return m_file->stat();
+		}
+
+		void sync() override
+		{
+			m_file->sync();
+		}
+
+		bool trunc(u64 length) override
+		{
+			m_buf_size = 0;
+			return m_file->trunc(length);
+		}
+
+		u64 read(void* buffer, u64 count) override
+		{
+			const auto dst = static_cast<u8*>(buffer);
+
+			u64 result = 0;
+
+			while (result < count)
+			{
+				if (m_pos >= m_buf_pos && m_pos - m_buf_pos < m_buf_size)
+				{
+					// Copy buffered data
+					const u64 offset = m_pos - m_buf_pos;
+					const u64 size = std::min<u64>(count - result, m_buf_size - offset);
+					std::memcpy(dst + result, m_buf.get() + offset, size);
+					m_pos += size;
+					result += size;
+					continue;
+				}
+
+				if (count - result >= m_buf_max)
+				{
+					// Read big chunks directly
+					const u64 size = m_file->read_at(m_pos, dst + result, count - result);
+					m_pos += size;
+					result += size;
+					break;
+				}
+
+				// Refill the buffer
+				m_buf_pos = m_pos;
+				m_buf_size = m_file->read_at(m_pos, m_buf.get(), m_buf_max);
+
+				if (!m_buf_size)
+				{
+					break;
+				}
+			}
+
+			return result;
+		}
+
+		u64 write(const void* buffer, u64 count) override
+		{
+			m_buf_size = 0;
+			m_file->seek(m_pos, seek_set);
+			const u64 result = m_file->write(buffer, count);
+			m_pos = m_file->seek(0, seek_cur);
+			return result;
+		}
+
+		u64 seek(s64 offset, seek_mode whence) override
+		{
+			const s64 new_pos =
+				whence == seek_set ? offset :
+				whence == seek_cur ? offset + m_pos :
+				whence == seek_end ? offset + size() :
+				(fmt::throw_exception("Invalid whence (0x%x)" HERE, whence), 0);
+
+			if (new_pos < 0)
+			{
+				g_tls_error = fs::error::inval;
+				return -1;
+			}
+
+			m_pos = new_pos;
+			return m_pos;
+		}
+
+		u64 size() override
+		{
+			return m_file->size();
+		}
+
+		u64 read_at(u64 offset, void* buffer, u64 count) override
+		{
+			return m_file->read_at(offset, buffer, count);
+		}
+
+		u64 write_at(u64 offset, const void* buffer, u64 count) override
+		{
+			m_buf_size = 0;
+			return m_file->write_at(offset, buffer, count);
+		}
+
+		std::unique_ptr<view_base> map() override
+		{
+			return m_file->map();
+		}
+
+		native_handle get() override
+		{
+			if (auto getter = dynamic_cast<get_native_handle*>(m_file.get()))
+			{
+				return getter->get();
+			}
+
+#ifdef _WIN32
+			return INVALID_HANDLE_VALUE;
+#else
+			return -1;
+#endif
+		}
+	};
+
+	m_file = std::make_unique<buffered_file>(std::move(m_file), size);
+}
+
 void fs::dir::xnull() const
 {
 	fmt::throw_exception<std::logic_error>("fs::dir is null");
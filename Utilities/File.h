@@ -71,6 +71,15 @@ namespace fs
 		virtual native_handle get() = 0;
 	};
 
+	// Read-only memory view of the file
+	struct view_base
+	{
+		virtual ~view_base();
+
+		virtual const u8* data() = 0;
+		virtual u64 size() = 0;
+	};
+
 	// File handle base
 	struct file_base
 	{
@@ -83,6 +92,13 @@ namespace fs
 		virtual u64 write(const void* buffer, u64 size) = 0;
 		virtual u64 seek(s64 offset, seek_mode whence) = 0;
 		virtual u64 size() = 0;
+
+		// Default implementations use seek() and restore the position (not thread-safe)
+		virtual u64 read_at(u64 offset, void* buffer, u64 size);
+		virtual u64 write_at(u64 offset, const void* buffer, u64 size);
+
+		// Not supported by default (returns nullptr)
+		virtual std::unique_ptr<view_base> map();
 	};
 
 	// Directory entry (TODO)
@@ -271,6 +287,30 @@ namespace fs
 			return m_file->size();
 		}
 
+		// Read the data at specified offset without changing the current position (thread-safe for native files)
+		u64 read_at(u64 offset, void* buffer, u64 count) const
+		{
+			if (!m_file) xnull();
+			return m_file->read_at(offset, buffer, count);
+		}
+
+		// Write the data at specified offset without changing the current position (thread-safe for native files)
+		u64 write_at(u64 offset, const void* buffer, u64 count) const
+		{
+			if (!m_file) xnull();
+			return m_file->write_at(offset, buffer, count);
+		}
+
+		// Create read-only memory view of the file (nullptr if not supported)
+		std::unique_ptr<view_base> map() const
+		{
+			if (!m_file) xnull();
+			return m_file->map();
+		}
+
+		// Add userspace read buffer of specified size (small reads don't cause a syscall each, position is preserved)
+		void set_read_buffer(std::size_t size = 0x10000);
+
 		// Get current position
 		u64 pos() const
 		{
@@ -345,6 +385,13 @@ namespace fs
 			return result;
 		}
 
+		// Read POD at specified offset, sizeof(T) is used
+		template<typename T>
+		std::enable_if_t<std::is_pod<T>::value && !std::is_pointer<T>::value, bool> read_at(u64 offset, T& data) const
+		{
+			return read_at(offset, &data, sizeof(T)) == sizeof(T);
+		}
+
 		// Read full file to std::string
 		std::string to_string() const
 		{
@@ -368,6 +415,43 @@ namespace fs
 		native_handle get_handle() const;
 	};
 
+	// Read-only memory mapping of the whole file (stays valid after the file is closed)
+	class file_view final
+	{
+		std::unique_ptr<view_base> m_view;
+
+	public:
+		file_view() = default;
+
+		// Map the file (fails for empty files or if the file doesn't support mapping)
+		explicit file_view(const file& f)
+			: m_view(f.map())
+		{
+		}
+
+		// Check whether the view is valid
+		explicit operator bool() const
+		{
+			return m_view.operator bool();
+		}
+
+		// Unmap explicitly
+		void close()
+		{
+			m_view.reset();
+		}
+
+		const u8* data() const
+		{
+			return m_view ? m_view->data() : nullptr;
+		}
+
+		u64 size() const
+		{
+			return m_view ? m_view->size() : 0;
+		}
+	};
+
 	class dir final
 	{
 		std::unique_ptr<dir_base> m_dir;
@@ -553,6 +637,23 @@ namespace fs
 			return 0;
 		}
 
+		u64 read_at(u64 offset, void* buffer, u64 size) override
+		{
+			const u64 end = obj.size();
+
+			if (offset < end)
+			{
+				// Get readable size
+				if (const u64 max = std::min<u64>(size, end - offset))
+				{
+					std::copy(obj.cbegin() + offset, obj.cbegin() + offset + max, static_cast<value_type*>(buffer));
+					return max;
+				}
+			}
+
+			return 0;
+		}
+
 		u64 write(const void* buffer, u64 size) override
 		{
 			const u64 old_size = obj.size();
@@ -413,6 +413,30 @@ public:
 	}
 };
 
+// Helper class
+class ObjectCallback final : public llvm::ObjectCache
+{
+	const std::function<void(const char*, std::size_t)>& m_func;
+
+public:
+	ObjectCallback(const std::function<void(const char*, std::size_t)>& func)
+		: m_func(func)
+	{
+	}
+
+	~ObjectCallback() override = default;
+
+	void notifyObjectCompiled(const llvm::Module* module, llvm::MemoryBufferRef obj) override
+	{
+		m_func(obj.getBufferStart(), obj.getBufferSize());
+	}
+
+	std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module* module) override
+	{
+		return nullptr;
+	}
+};
+
 std::string jit_compiler::cpu(const std::string& _cpu)
 {
 	std::string m_cpu = _cpu;
@@ -519,6 +543,17 @@ bool jit_compiler::has_ssse3() const
 	return true;
 }
 
+bool jit_compiler::has_avx512bw() const
+{
+	// Host CPU is downgraded in jit_compiler::cpu() if AVX-512 is unusable
+	return m_cpu == "skylake-avx512" ||
+		m_cpu == "cascadelake" ||
+		m_cpu == "cannonlake" ||
+		m_cpu == "icelake" ||
+		m_cpu == "icelake-client" ||
+		m_cpu == "icelake-server";
+}
+
 void jit_compiler::add(std::unique_ptr<llvm::Module> module, const std::string& path)
 {
 	ObjectCache cache{path};
@@ -536,6 +571,23 @@ void jit_compiler::add(std::unique_ptr<llvm::Module> module, const std::string&
 	}
 }
 
+void jit_compiler::add(std::unique_ptr<llvm::Module> module, const std::function<void(const char*, std::size_t)>& on_compiled)
+{
+	ObjectCallback cache{on_compiled};
+	m_engine->setObjectCache(&cache);
+
+	const auto ptr = module.get();
+	m_engine->addModule(std::move(module));
+	m_engine->generateCodeForModule(ptr);
+	m_engine->setObjectCache(nullptr);
+
+	for (auto& func : ptr->functions())
+	{
+		// Delete IR to lower memory consumption
+		func.deleteBody();
+	}
+}
+
 void jit_compiler::add(std::unique_ptr<llvm::Module> module)
 {
 	const auto ptr = module.get();
@@ -554,6 +606,13 @@ void jit_compiler::add(const std::string& path)
 	m_engine->addObjectFile(std::move(llvm::object::ObjectFile::createObjectFile(*ObjectCache::load(path)).get()));
 }
 
+void jit_compiler::add(const char* data, std::size_t size)
+{
+	auto buf = llvm::MemoryBuffer::getMemBufferCopy(llvm::StringRef(data, size));
+	auto obj = std::move(llvm::object::ObjectFile::createObjectFile(*buf).get());
+	m_engine->addObjectFile(llvm::object::OwningBinary<llvm::object::ObjectFile>(std::move(obj), std::move(buf)));
+}
+
 void jit_compiler::fin()
 {
 	m_engine->finalizeObject();
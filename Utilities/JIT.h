@@ -114,15 +114,24 @@ public:
 	// Test SSSE3 feature
 	bool has_ssse3() const;
 
+	// Test AVX-512BW feature
+	bool has_avx512bw() const;
+
 	// Add module (path to obj cache dir)
 	void add(std::unique_ptr<llvm::Module> module, const std::string& path);
 
 	// Add module (not cached)
 	void add(std::unique_ptr<llvm::Module> module);
 
+	// Add module (compiled object is passed to the callback instead of the cache dir)
+	void add(std::unique_ptr<llvm::Module> module, const std::function<void(const char* data, std::size_t size)>& on_compiled);
+
 	// Add object (path to obj file)
 	void add(const std::string& path);
 
+	// Add object (copied from memory)
+	void add(const char* data, std::size_t size);
+
 	// Finalize
 	void fin();
 
@@ -611,7 +611,9 @@ void logs::file_listener::log(u64 stamp, const logs::message& msg, const std::st
 	const u64 mins = (stamp % 3600'000'000) / 60'000'000;
 	const u64 secs = (stamp % 60'000'000) / 1'000'000;
 	const u64 frac = (stamp % 1'000'000);
-	fmt::append(text, "%u:%02u:%02u.%06u ", hours, mins, secs, frac);
+	static_assert(fmt::check_format<u64, u64, u64, u64>("%u:%02u:%02u.%06u "), "");
+	char stamp_text[32];
+	text.append(stamp_text, std::min<std::size_t>(fmt::format_to(stamp_text, "%u:%02u:%02u.%06u ", hours, mins, secs, frac), sizeof(stamp_text) - 1));
 
 	if (prefix.size() > 0)
 	{
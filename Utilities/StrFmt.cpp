@@ -4,6 +4,7 @@
 #include "cfmt.h"
 
 #include <algorithm>
+#include <cstring>
 
 #ifdef _WIN32
 #include <Windows.h>
@@ -279,8 +280,118 @@ namespace fmt
 	template void raw_throw_exception<std::underflow_error>(const char*, const fmt_type_info*, const u64*);
 
 	struct cfmt_src;
+	class cfmt_buffer;
 }
 
+// Fixed buffer output for cfmt_append (switches to std::string storage on overflow, so the result is never broken)
+class fmt::cfmt_buffer
+{
+	char* const m_buf;
+	char* m_ptr;
+	std::size_t m_cap; // Excluding null terminator
+	std::size_t m_size = 0;
+	std::string m_heap;
+
+	void grow(std::size_t size)
+	{
+		if (size <= m_cap)
+		{
+			return;
+		}
+
+		if (m_ptr == m_buf)
+		{
+			m_heap.assign(m_buf, m_size);
+		}
+
+		m_heap.resize(std::max<std::size_t>({size, m_cap * 2, 64}));
+		m_ptr = &m_heap.front();
+		m_cap = m_heap.size();
+	}
+
+public:
+	cfmt_buffer(char* buf, std::size_t cap)
+		: m_buf(buf)
+		, m_ptr(buf)
+		, m_cap(cap)
+	{
+	}
+
+	// Result location (m_buf if fits)
+	const char* data() const
+	{
+		return m_ptr;
+	}
+
+	std::size_t size() const
+	{
+		return m_size;
+	}
+
+	char* begin()
+	{
+		return m_ptr;
+	}
+
+	char* end()
+	{
+		return m_ptr + m_size;
+	}
+
+	std::reverse_iterator<char*> rbegin()
+	{
+		return std::reverse_iterator<char*>(end());
+	}
+
+	char& front()
+	{
+		return *m_ptr;
+	}
+
+	char& operator[](std::size_t index)
+	{
+		return m_ptr[index];
+	}
+
+	void push_back(char ch)
+	{
+		grow(m_size + 1);
+		m_ptr[m_size++] = ch;
+	}
+
+	void resize(std::size_t size, char ch = 0)
+	{
+		grow(size);
+
+		if (size > m_size)
+		{
+			std::memset(m_ptr + m_size, ch, size - m_size);
+		}
+
+		m_size = size;
+	}
+
+	void insert(char* pos, std::size_t count, char ch)
+	{
+		const std::size_t index = pos - m_ptr;
+		grow(m_size + count);
+		std::memmove(m_ptr + index + count, m_ptr + index, m_size - index);
+		std::memset(m_ptr + index, ch, count);
+		m_size += count;
+	}
+
+	template <typename It>
+	void insert(char* pos, It first, It last)
+	{
+		const std::size_t index = pos - m_ptr;
+		const std::size_t count = std::distance(first, last);
+		grow(m_size + count);
+		std::memmove(m_ptr + index + count, m_ptr + index, m_size - index);
+		std::copy(first, last, m_ptr + index);
+		m_size += count;
+	}
+};
+
 // Temporary implementation
 struct fmt::cfmt_src
 {
@@ -316,6 +427,37 @@ struct fmt::cfmt_src
 		return out.size() - start;
 	}
 
+	std::size_t fmt_string(cfmt_buffer& out, std::size_t extra) const
+	{
+		const std::size_t start = out.size();
+		const auto func = sup[extra].fmt_string;
+
+		// Copy strings directly, format other types via temporary string
+		const char* str = nullptr;
+
+		if (func == &fmt_class_string<const char*>::format && args[extra])
+		{
+			str = reinterpret_cast<const char*>(static_cast<std::uintptr_t>(args[extra]));
+		}
+		else if (func == &fmt_class_string<std::string>::format)
+		{
+			str = fmt_class_string<std::string>::get_object(args[extra]).c_str();
+		}
+
+		if (str)
+		{
+			out.insert(out.end(), str, str + std::strlen(str));
+		}
+		else
+		{
+			std::string temp;
+			func(temp, args[extra]);
+			out.insert(out.end(), temp.cbegin(), temp.cend());
+		}
+
+		return out.size() - start;
+	}
+
 	// Returns type size (0 if unknown, pointer, unsigned, assumed max)
 	std::size_t type(std::size_t extra) const
 	{
@@ -350,6 +492,26 @@ void fmt::raw_append(std::string& out, const char* fmt, const fmt_type_info* sup
 	cfmt_append(out, fmt, cfmt_src{sup, args});
 }
 
+std::size_t fmt::raw_format_to(char* buf, std::size_t size, const char* fmt, const fmt_type_info* sup, const u64* args)
+{
+	cfmt_buffer out(buf, size ? size - 1 : 0);
+	cfmt_append(out, fmt, cfmt_src{sup, args});
+
+	if (size)
+	{
+		const std::size_t count = std::min<std::size_t>(out.size(), size - 1);
+
+		if (out.data() != buf)
+		{
+			std::memcpy(buf, out.data(), count);
+		}
+
+		buf[count] = '\0';
+	}
+
+	return out.size();
+}
+
 std::string fmt::replace_first(const std::string& src, const std::string& from, const std::string& to)
 {
 	auto pos = src.find(from);
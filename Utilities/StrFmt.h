@@ -298,6 +298,111 @@ namespace fmt
 		return result;
 	}
 
+	// Internal formatting function (fixed buffer)
+	std::size_t raw_format_to(char* buf, std::size_t size, const char*, const fmt_type_info*, const u64*);
+
+	// Formatting function (allocates only if the result doesn't fit or for class formatters, may throw; truncates result to the buffer size including null terminator, returns untruncated length)
+	template <typename... Args>
+	SAFE_BUFFERS FORCE_INLINE std::size_t format_to(char* buf, std::size_t size, const char* fmt, const Args&... args)
+	{
+		return raw_format_to(buf, size, fmt, fmt::get_type_info<fmt_unveil_t<Args>...>(), fmt_args_t<Args...>{fmt_unveil<Args>::get(args)...});
+	}
+
+	// Formatting function (array buffer)
+	template <std::size_t N, typename... Args>
+	SAFE_BUFFERS FORCE_INLINE std::size_t format_to(char(&buf)[N], const char* fmt, const Args&... args)
+	{
+		return raw_format_to(buf, N, fmt, fmt::get_type_info<fmt_unveil_t<Args>...>(), fmt_args_t<Args...>{fmt_unveil<Args>::get(args)...});
+	}
+
+	// Compile-time format check (use in static_assert): only simple sequences, integral conversions need integral or enum arguments
+	template <typename... Args>
+	constexpr bool check_format(const char* fmt)
+	{
+		const bool is_int[sizeof...(Args) + 1]{(std::is_integral<fmt_unveil_t<Args>>::value || std::is_enum<fmt_unveil_t<Args>>::value)..., false};
+		const bool is_float[sizeof...(Args) + 1]{std::is_floating_point<fmt_unveil_t<Args>>::value..., false};
+
+		std::size_t arg = 0;
+
+		while (*fmt)
+		{
+			if (*fmt++ != '%')
+			{
+				continue;
+			}
+
+			if (*fmt == '%')
+			{
+				fmt++;
+				continue;
+			}
+
+			// Flags, width and precision ('*' is not supported)
+			while (*fmt == '-' || *fmt == '+' || *fmt == ' ' || *fmt == '#' || *fmt == '.' || (*fmt >= '0' && *fmt <= '9'))
+			{
+				fmt++;
+			}
+
+			// Length modifiers
+			while (*fmt == 'h' || *fmt == 'l' || *fmt == 'z' || *fmt == 'j' || *fmt == 't')
+			{
+				fmt++;
+			}
+
+			if (arg >= sizeof...(Args))
+			{
+				return false;
+			}
+
+			switch (*fmt++)
+			{
+			case 'd':
+			case 'i':
+			case 'u':
+			case 'o':
+			case 'x':
+			case 'X':
+			case 'c':
+			{
+				if (!is_int[arg++])
+				{
+					return false;
+				}
+
+				break;
+			}
+			case 'f':
+			case 'F':
+			case 'e':
+			case 'E':
+			case 'g':
+			case 'G':
+			case 'a':
+			case 'A':
+			{
+				if (!is_float[arg++])
+				{
+					return false;
+				}
+
+				break;
+			}
+			case 's':
+			case 'p':
+			{
+				arg++;
+				break;
+			}
+			default:
+			{
+				return false;
+			}
+			}
+		}
+
+		return arg == sizeof...(Args);
+	}
+
 	// Internal exception message formatting template, must be explicitly specialized or instantiated in cpp to minimize code bloat
 	template <typename T>
 	[[noreturn]] void raw_throw_exception(const char*, const fmt_type_info*, const u64*);
@@ -1553,6 +1553,8 @@ extern thread_local std::string(*g_tls_log_prefix)();
 
 DECLARE(thread_ctrl::g_native_core_layout) { native_core_arrangement::undefined };
 
+DECLARE(thread_ctrl::g_exited_cpu_time) {};
+
 void thread_ctrl::start(const std::shared_ptr<thread_ctrl>& ctrl, task_stack task)
 {
 #ifdef _WIN32
@@ -1686,6 +1688,10 @@ void thread_ctrl::finalize(std::exception_ptr eptr) noexcept
 		g_tls_fault_rsx,
 		g_tls_fault_spu);
 
+	// Account CPU time of the finished thread
+	g_exited_cpu_time[static_cast<u32>(m_class)] += get_cpu_time();
+	m_exited = true;
+
 	--g_thread_count;
 
 	// Untangle circular reference, set exception
@@ -1882,6 +1888,43 @@ u64 thread_ctrl::get_cycles()
 	}
 }
 
+u64 thread_ctrl::get_cpu_time() const
+{
+	if (m_exited)
+	{
+		return 0;
+	}
+
+#ifdef _WIN32
+	u64 cycles;
+
+	if (QueryThreadCycleTime((HANDLE)m_thread.load(), &cycles))
+	{
+		return cycles;
+	}
+#elif defined(__APPLE__)
+	thread_basic_info_data_t info;
+	mach_msg_type_number_t count = THREAD_BASIC_INFO_COUNT;
+
+	if (thread_info(pthread_mach_thread_np((pthread_t)m_thread.load()), THREAD_BASIC_INFO, (thread_info_t)&info, &count) == KERN_SUCCESS)
+	{
+		const u64 sec = static_cast<u64>(info.user_time.seconds) + info.system_time.seconds;
+		const u64 usec = static_cast<u64>(info.user_time.microseconds) + info.system_time.microseconds;
+		return sec * 1'000'000'000 + usec * 1000;
+	}
+#else
+	clockid_t clock;
+	struct timespec thread_time;
+
+	if (!pthread_getcpuclockid((pthread_t)m_thread.load(), &clock) && !clock_gettime(clock, &thread_time))
+	{
+		return static_cast<u64>(thread_time.tv_sec) * 1'000'000'000 + thread_time.tv_nsec;
+	}
+#endif
+
+	return 0;
+}
+
 void thread_ctrl::test()
 {
 	const auto _this = g_tls_this_thread;
@@ -141,6 +141,15 @@ class thread_ctrl final
 	// CPU cycles thread has run for
 	u64 m_cycles{0};
 
+	// Thread class (for CPU time accounting)
+	thread_class m_class = thread_class::general;
+
+	// Set when the thread has finished (its CPU time is added to g_exited_cpu_time)
+	atomic_t<bool> m_exited{false};
+
+	// Total CPU time of finished threads per thread class
+	static atomic_t<u64> g_exited_cpu_time[4];
+
 	// Start thread
 	static void start(const std::shared_ptr<thread_ctrl>&, task_stack);
 
@@ -178,6 +187,28 @@ public:
 	// Get CPU cycles since last time this function was called. First call returns 0.
 	u64 get_cycles();
 
+	// Get total CPU time of the thread (cycles on Windows, nanoseconds elsewhere), can be called from any thread.
+	// Returns 0 on failure or if the thread has finished (its time is then included in get_exited_cpu_time()).
+	u64 get_cpu_time() const;
+
+	// Get total CPU time of finished threads of the class (accounted at thread exit)
+	static u64 get_exited_cpu_time(thread_class group)
+	{
+		return g_exited_cpu_time[static_cast<u32>(group)];
+	}
+
+	// Get thread class
+	thread_class get_class() const
+	{
+		return m_class;
+	}
+
+	// Set class of the current thread
+	static void set_class(thread_class group)
+	{
+		g_tls_this_thread->m_class = group;
+	}
+
 	// Get platform-specific thread handle
 	std::uintptr_t get_native_handle() const
 	{
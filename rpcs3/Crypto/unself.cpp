@@ -4,10 +4,53 @@
 #include "utils.h"
 #include "unself.h"
 #include "Emu/VFS.h"
+#include "Utilities/Thread.h"
 
 #include <algorithm>
+#include <thread>
 #include <zlib.h>
 
+// Call func(index) for each index in [0, count) using worker threads (data size in bytes is used to skip threading for small files)
+template <typename F>
+static void self_parallel_for(u32 count, u64 data_size, F func)
+{
+	const u32 threads = data_size < 0x100000 ? 1 : std::min<u32>(count, std::max<u32>(std::thread::hardware_concurrency(), 1));
+
+	if (threads <= 1)
+	{
+		for (u32 i = 0; i < count; i++)
+		{
+			func(i);
+		}
+
+		return;
+	}
+
+	atomic_t<u32> next{0};
+
+	const auto work = [&]()
+	{
+		for (u32 i; (i = next++) < count;)
+		{
+			func(i);
+		}
+	};
+
+	std::vector<std::shared_ptr<thread_ctrl>> workers(threads - 1);
+
+	for (auto& worker : workers)
+	{
+		thread_ctrl::spawn(worker, "SELF Decrypter Worker", work);
+	}
+
+	work();
+
+	for (auto& worker : workers)
+	{
+		worker->join();
+	}
+}
+
 inline u8 Read8(const fs::file& f)
 {
 	u8 ret;
@@ -1207,7 +1250,8 @@ bool SELFDecrypter::LoadMetadata(u8* klic_key)
 
 bool SELFDecrypter::DecryptData()
 {
-	aes_context aes;
+	// Encrypted sections with valid key and iv (section index, offset in data_buf)
+	std::vector<std::pair<u32, u32>> sections;
 
 	// Calculate the total data size.
 	for (unsigned int i = 0; i < meta_hdr.section_count; i++)
@@ -1215,56 +1259,38 @@ bool SELFDecrypter::DecryptData()
 		if (meta_shdr[i].encrypted == 3)
 		{
 			if ((meta_shdr[i].key_idx <= meta_hdr.key_count - 1) && (meta_shdr[i].iv_idx <= meta_hdr.key_count))
+			{
+				sections.emplace_back(i, data_buf_length);
 				data_buf_length += meta_shdr[i].data_size;
+			}
 		}
 	}
 
 	// Allocate a buffer to store decrypted data.
 	data_buf = std::make_unique<u8[]>(data_buf_length);
 
-	// Set initial offset.
-	u32 data_buf_offset = 0;
-
-	// Parse the metadata section headers to find the offsets of encrypted data.
-	for (unsigned int i = 0; i < meta_hdr.section_count; i++)
+	// Read and decrypt the sections in place (independent AES-CTR streams, positioned reads don't share the file position).
+	self_parallel_for(::size32(sections), data_buf_length, [&](u32 index)
 	{
+		const u32 i = sections[index].first;
+		u8* const data = data_buf.get() + sections[index].second;
+
+		self_f.read_at(meta_shdr[i].data_offset, data, meta_shdr[i].data_size);
+
+		aes_context aes;
 		size_t ctr_nc_off = 0;
-		u8 ctr_stream_block[0x10];
+		u8 ctr_stream_block[0x10]{};
 		u8 data_key[0x10];
 		u8 data_iv[0x10];
 
-		// Check if this is an encrypted section.
-		if (meta_shdr[i].encrypted == 3)
-		{
-			// Make sure the key and iv are not out of boundaries.
-			if((meta_shdr[i].key_idx <= meta_hdr.key_count - 1) && (meta_shdr[i].iv_idx <= meta_hdr.key_count))
-			{
-				// Get the key and iv from the previously stored key buffer.
-				memcpy(data_key, data_keys.get() + meta_shdr[i].key_idx * 0x10, 0x10);
-				memcpy(data_iv, data_keys.get() + meta_shdr[i].iv_idx * 0x10, 0x10);
+		// Get the key and iv from the previously stored key buffer.
+		memcpy(data_key, data_keys.get() + meta_shdr[i].key_idx * 0x10, 0x10);
+		memcpy(data_iv, data_keys.get() + meta_shdr[i].iv_idx * 0x10, 0x10);
 
-				// Allocate a buffer to hold the data.
-				auto buf = std::make_unique<u8[]>(meta_shdr[i].data_size);
-
-				// Seek to the section data offset and read the encrypted data.
-				self_f.seek(meta_shdr[i].data_offset);
-				self_f.read(buf.get(), meta_shdr[i].data_size);
-
-				// Zero out our ctr nonce.
-				memset(ctr_stream_block, 0, sizeof(ctr_stream_block));
-
-				// Perform AES-CTR encryption on the data blocks.
-				aes_setkey_enc(&aes, data_key, 128);
-				aes_crypt_ctr(&aes, meta_shdr[i].data_size, &ctr_nc_off, data_iv, ctr_stream_block, buf.get(), buf.get());
-
-				// Copy the decrypted data.
-				memcpy(data_buf.get() + data_buf_offset, buf.get(), meta_shdr[i].data_size);
-
-				// Advance the buffer's offset.
-				data_buf_offset += meta_shdr[i].data_size;
-			}
-		}
-	}
+		// Perform AES-CTR encryption on the data blocks.
+		aes_setkey_enc(&aes, data_key, 128);
+		aes_crypt_ctr(&aes, meta_shdr[i].data_size, &ctr_nc_off, data_iv, ctr_stream_block, data, data);
+	});
 
 	return true;
 }
@@ -1324,42 +1350,64 @@ fs::file SELFDecrypter::MakeElf(bool isElf32)
 			WritePhdr(e, phdr64_arr[i]);
 		}
 
+		// Find compressed segments and their offsets in the data buffer.
+		std::vector<u32> offsets(meta_hdr.section_count);
+		std::vector<u32> compressed;
+
+		for (unsigned int i = 0; i < meta_hdr.section_count; i++)
+		{
+			if (meta_shdr[i].type == 2)
+			{
+				offsets[i] = data_buf_offset;
+				data_buf_offset += meta_shdr[i].data_size;
+
+				if (meta_shdr[i].compressed == 2)
+				{
+					compressed.push_back(i);
+				}
+			}
+		}
+
+		data_buf_offset = 0;
+
+		// Decompress the segments in parallel.
+		std::vector<std::unique_ptr<u8[]>> decomp_bufs(meta_hdr.section_count);
+
+		self_parallel_for(::size32(compressed), data_buf_length, [&](u32 index)
+		{
+			const u32 i = compressed[index];
+			const u64 size = phdr64_arr[meta_shdr[i].program_idx].p_filesz;
+
+			auto decomp_buf = std::make_unique<u8[]>(size);
+			uLongf decomp_buf_length = static_cast<uLongf>(size);
+
+			// The compressed stream is read directly from data_buf.
+			const int rv = uncompress(decomp_buf.get(), &decomp_buf_length, data_buf.get() + offsets[i], data_buf_length - offsets[i]);
+
+			// Check for errors (TODO: Probably safe to remove this once these changes have passed testing.)
+			switch (rv)
+			{
+			case Z_MEM_ERROR:	LOG_ERROR(LOADER, "MakeELF encountered a Z_MEM_ERROR!"); break;
+			case Z_BUF_ERROR:	LOG_ERROR(LOADER, "MakeELF encountered a Z_BUF_ERROR!"); break;
+			case Z_DATA_ERROR:	LOG_ERROR(LOADER, "MakeELF encountered a Z_DATA_ERROR!"); break;
+			default: break;
+			}
+
+			decomp_bufs[i] = std::move(decomp_buf);
+		});
+
 		// Write data.
 		for (unsigned int i = 0; i < meta_hdr.section_count; i++)
 		{
 			// PHDR type.
 			if (meta_shdr[i].type == 2)
 			{
-				// Decompress if necessary.
+				// Write decompressed data if necessary.
 				if (meta_shdr[i].compressed == 2)
 				{
-					// Store the length in writeable memory space.
-					std::unique_ptr<uLongf> decomp_buf_length(new uLongf);
-					memcpy(decomp_buf_length.get(), &phdr64_arr[meta_shdr[i].program_idx].p_filesz, sizeof(uLongf));
-
-					/// Create a pointer to a buffer for decompression.
-					std::unique_ptr<u8[]> decomp_buf(new u8[phdr64_arr[meta_shdr[i].program_idx].p_filesz]);
-
-					// Create a buffer separate from data_buf to uncompress.
-					std::unique_ptr<u8[]> zlib_buf(new u8[data_buf_length]);
-					memcpy(zlib_buf.get(), data_buf.get(), data_buf_length);
-
-					// Use zlib uncompress on the new buffer.
-					// decomp_buf_length changes inside the call to uncompress, so it must be a pointer to correct type (in writeable mem space).
-					int rv = uncompress(decomp_buf.get(), decomp_buf_length.get(), zlib_buf.get() + data_buf_offset, data_buf_length);
-
-					// Check for errors (TODO: Probably safe to remove this once these changes have passed testing.)
-					switch (rv)
-					{
-					case Z_MEM_ERROR:	LOG_ERROR(LOADER, "MakeELF encountered a Z_MEM_ERROR!"); break;
-					case Z_BUF_ERROR:	LOG_ERROR(LOADER, "MakeELF encountered a Z_BUF_ERROR!"); break;
-					case Z_DATA_ERROR:	LOG_ERROR(LOADER, "MakeELF encountered a Z_DATA_ERROR!"); break;
-					default: break;
-					}
-
 					// Seek to the program header data offset and write the data.
 					e.seek(phdr64_arr[meta_shdr[i].program_idx].p_offset);
-					e.write(decomp_buf.get(), phdr64_arr[meta_shdr[i].program_idx].p_filesz);
+					e.write(decomp_bufs[i].get(), phdr64_arr[meta_shdr[i].program_idx].p_filesz);
 				}
 				else
 				{
@@ -1489,6 +1537,9 @@ extern fs::file decrypt_self(fs::file elf_or_self, u8* klic_key)
 	// Check SELF header first. Check for a debug SELF.
 	if (elf_or_self.size() >= 4 && elf_or_self.read<u32>() == "SCE\0"_u32 && !CheckDebugSelf(elf_or_self))
 	{
+		// Headers are parsed with many small reads
+		elf_or_self.set_read_buffer();
+
 		// Check the ELF file class (32 or 64 bit).
 		bool isElf32 = IsSelfElf32(elf_or_self);
 
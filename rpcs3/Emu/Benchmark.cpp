@@ -0,0 +1,240 @@
+#include "stdafx.h"
+#include "Benchmark.h"
+#include "System.h"
+#include "IdManager.h"
+#include "Emu/Cell/PPUThread.h"
+#include "Emu/Cell/SPUThread.h"
+#include "Emu/Cell/RawSPUThread.h"
+#include "Emu/RSX/GSRender.h"
+
+#include <algorithm>
+
+jit_counters g_jit_counters;
+
+// Escape string for JSON output
+static std::string json_string(const std::string& str)
+{
+	std::string result = "\"";
+
+	for (char c : str)
+	{
+		switch (c)
+		{
+		case '"': result += "\\\""; break;
+		case '\\': result += "\\\\"; break;
+		case '\n': result += "\\n"; break;
+		case '\t': result += "\\t"; break;
+		default:
+		{
+			if (static_cast<u8>(c) < 0x20)
+			{
+				fmt::append(result, "\\u%04x", static_cast<u8>(c));
+			}
+			else
+			{
+				result += c;
+			}
+		}
+		}
+	}
+
+	result += '"';
+	return result;
+}
+
+benchmark_thread::benchmark_thread(const std::string& path, u64 seconds, u64 flips)
+	: m_path(path)
+	, m_duration(seconds * 1000000)
+	, m_max_flips(flips)
+{
+}
+
+void benchmark_thread::sample()
+{
+	// Total CPU time: finished threads are accounted at exit, running threads are sampled
+	// Don't use get_cycles(): it measures the calling thread and is used by the performance overlay
+	m_ppu_cycles = thread_ctrl::get_exited_cpu_time(thread_class::ppu);
+	m_spu_cycles = thread_ctrl::get_exited_cpu_time(thread_class::spu);
+	m_rsx_cycles = thread_ctrl::get_exited_cpu_time(thread_class::rsx);
+
+	idm::select<ppu_thread>([&](u32, ppu_thread& ppu) { m_ppu_cycles += ppu.get()->get_cpu_time(); });
+	idm::select<SPUThread>([&](u32, SPUThread& spu) { m_spu_cycles += spu.get()->get_cpu_time(); });
+	idm::select<RawSPUThread>([&](u32, RawSPUThread& spu) { m_spu_cycles += spu.get()->get_cpu_time(); });
+
+	const auto rsx = fxm::get<GSRender>();
+
+	if (!rsx)
+	{
+		return;
+	}
+
+	m_rsx_cycles += rsx->get()->get_cpu_time();
+	m_rsx_detailed = rsx->performance_counters.detailed;
+
+	// Statistics published by the RSX thread on flip
+	reader_lock lock(rsx->performance_counters.flip_mutex);
+
+	m_rsx_stats = rsx->performance_counters.frontend_flip;
+
+	// Collect new flip timestamps
+	const auto& ring = rsx->performance_counters.flip_times;
+	const u64 count = rsx->performance_counters.flip_count;
+
+	if (count - m_flip_pos > ring.size())
+	{
+		LOG_ERROR(GENERAL, "Benchmark: %u flip timestamps lost", count - m_flip_pos - ring.size());
+		m_flip_pos = count - ring.size();
+	}
+
+	for (; m_flip_pos < count; m_flip_pos++)
+	{
+		m_flips.push_back(ring[m_flip_pos % ring.size()]);
+	}
+}
+
+void benchmark_thread::on_task()
+{
+	// Set baseline (previous flips and cycles are discarded)
+	sample();
+	m_flips.clear();
+	m_ppu_base = m_ppu_cycles;
+	m_spu_base = m_spu_cycles;
+	m_rsx_base_cycles = m_rsx_cycles;
+	m_rsx_base = m_rsx_stats;
+
+	const u64 start = get_system_time();
+
+	LOG_NOTICE(GENERAL, "Benchmark started (duration=%us, flips=%u)", m_duration / 1000000, m_max_flips);
+
+	while (!Emu.IsStopped())
+	{
+		thread_ctrl::wait_for(100000);
+
+		sample();
+
+		if (m_finished || (m_duration && get_system_time() - start >= m_duration) || (m_max_flips && m_flips.size() >= m_max_flips))
+		{
+			break;
+		}
+	}
+
+	report(start, get_system_time());
+
+	Emu.CallAfter([]()
+	{
+		Emu.Stop();
+		Emu.GetCallbacks().exit();
+	});
+}
+
+void benchmark_thread::finish()
+{
+	m_finished = true;
+	notify();
+}
+
+bool benchmark_thread::report(u64 start, u64 stop)
+{
+	const bool complete = m_finished || !Emu.IsStopped();
+
+	// Frame times in microseconds
+	std::vector<u64> frames;
+
+	for (std::size_t i = 1; i < m_flips.size(); i++)
+	{
+		frames.push_back(m_flips[i] - m_flips[i - 1]);
+	}
+
+	std::sort(frames.begin(), frames.end());
+
+	auto percentile = [&](double p) -> double
+	{
+		if (frames.empty())
+		{
+			return 0.;
+		}
+
+		const std::size_t index = std::min<std::size_t>(frames.size() - 1, static_cast<std::size_t>(p / 100. * frames.size()));
+		return frames[index] / 1000.;
+	};
+
+	u64 frame_sum = 0;
+
+	for (u64 t : frames)
+	{
+		frame_sum += t;
+	}
+
+	const double elapsed = (stop - start) / 1000000.;
+
+	const u64 ppu_total = g_jit_counters.ppu_compiled + g_jit_counters.ppu_cached;
+	const u64 spu_total = g_jit_counters.spu_compiled + g_jit_counters.spu_cached;
+
+	const u64 fifo_commands = m_rsx_stats.fifo_commands - m_rsx_base.fifo_commands;
+	const u64 draw_calls = m_rsx_stats.draw_calls - m_rsx_base.draw_calls;
+
+	std::string json = "{\n";
+	fmt::append(json, "\t\"title\": %s,\n", json_string(Emu.GetTitle()));
+	fmt::append(json, "\t\"title_id\": %s,\n", json_string(Emu.GetTitleID()));
+	fmt::append(json, "\t\"complete\": %s,\n", complete ? "true" : "false");
+	fmt::append(json, "\t\"duration\": %.3f,\n", elapsed);
+	fmt::append(json, "\t\"flips\": %u,\n", m_flips.size());
+	fmt::append(json, "\t\"fps\": %.3f,\n", elapsed > 0. ? m_flips.size() / elapsed : 0.);
+	json += "\t\"frame_time_ms\": {\n";
+	fmt::append(json, "\t\t\"avg\": %.3f,\n", frames.empty() ? 0. : frame_sum / 1000. / frames.size());
+	fmt::append(json, "\t\t\"min\": %.3f,\n", frames.empty() ? 0. : frames.front() / 1000.);
+	fmt::append(json, "\t\t\"p50\": %.3f,\n", percentile(50));
+	fmt::append(json, "\t\t\"p90\": %.3f,\n", percentile(90));
+	fmt::append(json, "\t\t\"p99\": %.3f,\n", percentile(99));
+	fmt::append(json, "\t\t\"max\": %.3f\n", frames.empty() ? 0. : frames.back() / 1000.);
+	json += "\t},\n";
+	json += "\t\"cpu_time\": {\n";
+#ifdef _WIN32
+	json += "\t\t\"unit\": \"cycles\",\n";
+#else
+	json += "\t\t\"unit\": \"ns\",\n";
+#endif
+	fmt::append(json, "\t\t\"ppu\": %u,\n", m_ppu_cycles - m_ppu_base);
+	fmt::append(json, "\t\t\"spu\": %u,\n", m_spu_cycles - m_spu_base);
+	fmt::append(json, "\t\t\"rsx\": %u\n", m_rsx_cycles - m_rsx_base_cycles);
+	json += "\t},\n";
+	json += "\t\"rsx\": {\n";
+	fmt::append(json, "\t\t\"detailed\": %s,\n", m_rsx_detailed ? "true" : "false");
+	fmt::append(json, "\t\t\"fifo_commands\": %u,\n", fifo_commands);
+	fmt::append(json, "\t\t\"commands_per_sec\": %.1f,\n", elapsed > 0. ? fifo_commands / elapsed : 0.);
+	fmt::append(json, "\t\t\"draw_calls\": %u,\n", draw_calls);
+	fmt::append(json, "\t\t\"draws_per_sec\": %.1f,\n", elapsed > 0. ? draw_calls / elapsed : 0.);
+	fmt::append(json, "\t\t\"decode_ms\": %.3f,\n", (m_rsx_stats.decode_time - m_rsx_base.decode_time) / 1000000.);
+	fmt::append(json, "\t\t\"vertex_upload_ms\": %.3f,\n", (m_rsx_stats.vertex_upload_time - m_rsx_base.vertex_upload_time) / 1000000.);
+	fmt::append(json, "\t\t\"texture_cache_ms\": %.3f\n", (m_rsx_stats.texture_time - m_rsx_base.texture_time) / 1000000.);
+	json += "\t},\n";
+	json += "\t\"jit\": {\n";
+	fmt::append(json, "\t\t\"opt_level\": %s,\n", json_string(g_cfg.core.llvm_opt.to_string()));
+	json += "\t\t\"ppu\": {\n";
+	fmt::append(json, "\t\t\t\"compiled\": %u,\n", g_jit_counters.ppu_compiled.load());
+	fmt::append(json, "\t\t\t\"cached\": %u,\n", g_jit_counters.ppu_cached.load());
+	fmt::append(json, "\t\t\t\"hit_rate\": %.4f,\n", ppu_total ? g_jit_counters.ppu_cached * 1. / ppu_total : 0.);
+	fmt::append(json, "\t\t\t\"compile_ms\": %.3f\n", g_jit_counters.ppu_time / 1000.);
+	json += "\t\t},\n";
+	json += "\t\t\"spu\": {\n";
+	fmt::append(json, "\t\t\t\"compiled\": %u,\n", g_jit_counters.spu_compiled.load());
+	fmt::append(json, "\t\t\t\"cached\": %u,\n", g_jit_counters.spu_cached.load());
+	fmt::append(json, "\t\t\t\"hit_rate\": %.4f,\n", spu_total ? g_jit_counters.spu_cached * 1. / spu_total : 0.);
+	fmt::append(json, "\t\t\t\"compile_ms\": %.3f\n", g_jit_counters.spu_time / 1000.);
+	json += "\t\t}\n";
+	json += "\t}\n";
+	json += "}\n";
+
+	fs::file out(m_path, fs::rewrite);
+
+	if (!out)
+	{
+		LOG_ERROR(GENERAL, "Failed to write benchmark report: %s (%s)", m_path, fs::g_tls_error);
+		return false;
+	}
+
+	out.write(json);
+
+	LOG_SUCCESS(GENERAL, "Benchmark report written: %s (%u flips in %.3fs)", m_path, m_flips.size(), elapsed);
+	return true;
+}
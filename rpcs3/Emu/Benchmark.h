@@ -0,0 +1,76 @@
+#pragma once
+
+#include "Utilities/Thread.h"
+#include "Emu/RSX/RSXThread.h"
+#include <string>
+#include <vector>
+
+// JIT statistics (always collected, reported in benchmark mode)
+struct jit_counters
+{
+	atomic_t<u64> ppu_compiled{0}; // PPU module parts compiled
+	atomic_t<u64> ppu_cached{0}; // PPU module parts found in the object cache
+	atomic_t<u64> ppu_time{0}; // PPU compilation time (us)
+	atomic_t<u64> spu_compiled{0}; // SPU blocks compiled
+	atomic_t<u64> spu_cached{0}; // SPU blocks found already compiled
+	atomic_t<u64> spu_time{0}; // SPU compilation time (us)
+
+	void reset()
+	{
+		ppu_compiled = 0;
+		ppu_cached = 0;
+		ppu_time = 0;
+		spu_compiled = 0;
+		spu_cached = 0;
+		spu_time = 0;
+	}
+};
+
+extern jit_counters g_jit_counters;
+
+// Benchmark mode: run for specified time or number of flips, write JSON report and stop the emulator
+class benchmark_thread final : public named_thread
+{
+	const std::string m_path;
+	const u64 m_duration; // Microseconds (0 = unlimited)
+	const u64 m_max_flips; // 0 = unlimited
+
+	// Flip timestamps
+	std::vector<u64> m_flips;
+
+	// Consumed RSX flip counter value
+	u64 m_flip_pos = 0;
+
+	// Total CPU time of the threads (baseline and last sample)
+	u64 m_ppu_base = 0;
+	u64 m_spu_base = 0;
+	u64 m_rsx_base_cycles = 0;
+	u64 m_ppu_cycles = 0;
+	u64 m_spu_cycles = 0;
+	u64 m_rsx_cycles = 0;
+
+	// RSX frontend statistics (baseline and last sample)
+	rsx::frontend_stats m_rsx_base;
+	rsx::frontend_stats m_rsx_stats;
+	bool m_rsx_detailed = false;
+
+	// Set when the workload signals completion
+	atomic_t<bool> m_finished{false};
+
+	void on_task() override;
+
+	std::string get_name() const override
+	{
+		return "Benchmark Thread";
+	}
+
+	void sample();
+
+	bool report(u64 start, u64 stop);
+
+public:
+	benchmark_thread(const std::string& path, u64 seconds, u64 flips);
+
+	// Stop benchmark and write report (workload completed)
+	void finish();
+};
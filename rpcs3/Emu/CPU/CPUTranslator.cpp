@@ -1,9 +1,63 @@
 #ifdef LLVM_AVAILABLE
 
 #include "CPUTranslator.h"
+#include "Emu/System.h"
+
+#include "restore_new.h"
+#ifdef _MSC_VER
+#pragma warning(push, 0)
+#endif
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/Transforms/Scalar.h"
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+#include "define_new_memleakdetect.h"
 
 llvm::LLVMContext g_llvm_ctx;
 
+void llvm_add_opt_passes(llvm::legacy::FunctionPassManager& pm, llvm_opt_level level)
+{
+	using namespace llvm;
+
+	switch (level)
+	{
+	case llvm_opt_level::fast:
+	{
+		pm.add(createEarlyCSEPass());
+		pm.add(createDeadStoreEliminationPass());
+		break;
+	}
+	case llvm_opt_level::balanced:
+	{
+		pm.add(createCFGSimplificationPass());
+		pm.add(createPromoteMemoryToRegisterPass());
+		pm.add(createEarlyCSEPass());
+		pm.add(createInstructionCombiningPass());
+		pm.add(createDeadStoreEliminationPass());
+		pm.add(createCFGSimplificationPass());
+		break;
+	}
+	case llvm_opt_level::aggressive:
+	{
+		pm.add(createCFGSimplificationPass());
+		pm.add(createPromoteMemoryToRegisterPass());
+		pm.add(createEarlyCSEPass());
+		pm.add(createInstructionCombiningPass());
+		pm.add(createReassociatePass());
+		pm.add(createLICMPass());
+		pm.add(createLoopInstSimplifyPass());
+		pm.add(createGVNPass());
+		pm.add(createSCCPPass());
+		pm.add(createDeadStoreEliminationPass());
+		pm.add(createInstructionCombiningPass());
+		pm.add(createAggressiveDCEPass());
+		pm.add(createCFGSimplificationPass());
+		break;
+	}
+	}
+}
+
 cpu_translator::cpu_translator(llvm::Module* module, bool is_be)
     : m_context(g_llvm_ctx)
 	, m_module(module)
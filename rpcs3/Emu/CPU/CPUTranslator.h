@@ -26,6 +26,19 @@
 #include <array>
 #include <vector>
 
+enum class llvm_opt_level;
+
+namespace llvm
+{
+	namespace legacy
+	{
+		class FunctionPassManager;
+	}
+}
+
+// Add function optimization passes for the specified tier
+void llvm_add_opt_passes(llvm::legacy::FunctionPassManager& pm, llvm_opt_level level);
+
 template <typename T = void>
 struct llvm_value_t
 {
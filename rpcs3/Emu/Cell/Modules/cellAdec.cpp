@@ -13,6 +13,8 @@ extern "C"
 #endif
 }
 
+#include "Utilities/cond.h"
+
 #include "cellPamf.h"
 #include "cellAdec.h"
 
@@ -30,6 +32,11 @@ public:
 	volatile bool is_closed;
 	volatile bool is_finished;
 	bool just_started;
+
+	// Signaled when is_finished is set
+	std::mutex done_mutex;
+	cond_variable done_cv;
+
 	bool just_finished;
 
 	AVCodec* codec;
@@ -401,7 +408,14 @@ public:
 			}
 		}
 
-		is_finished = true;
+		state += cpu_flag::exit;
+
+		{
+			std::lock_guard<std::mutex> lock(done_mutex);
+			is_finished = true;
+		}
+
+		done_cv.notify_all();
 	}
 };
 
@@ -612,9 +626,20 @@ s32 cellAdecClose(u32 handle)
 	adec->is_closed = true;
 	adec->job.try_push(AdecTask(adecClose));
 
-	while (!adec->is_finished)
 	{
-		thread_ctrl::wait_for(1000); // hack
+		std::unique_lock<std::mutex> lock(adec->done_mutex);
+
+		while (!adec->is_finished)
+		{
+			if (Emu.IsStopped())
+			{
+				cellAdec.warning("cellAdecClose(%d) aborted", handle);
+				return CELL_OK;
+			}
+
+			// Timeout is only necessary to check emulation stop
+			adec->done_cv.wait(lock, 100000);
+		}
 	}
 
 	idm::remove<ppu_thread>(handle);
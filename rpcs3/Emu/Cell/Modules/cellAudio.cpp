@@ -55,14 +55,118 @@ void audio_config::on_init(const std::shared_ptr<void>& _this)
 	named_thread::on_init(_this);
 }
 
+// Load 4 big-endian floats (SSE2)
+static inline __m128 audio_load_be(const be_t<f32>* src)
+{
+	const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+	const __m128i r = _mm_or_si128(_mm_slli_epi32(v, 16), _mm_srli_epi32(v, 16));
+	return _mm_castsi128_ps(_mm_or_si128(_mm_slli_epi16(r, 8), _mm_srli_epi16(r, 8)));
+}
+
+// Mix 2-channel port block (volume is applied per sample frame)
+template <bool First>
+static void audio_mix_2ch(const be_t<f32>* src, const f32* vol, f32* buf2ch, f32* buf8ch)
+{
+	const __m128 zero = _mm_setzero_ps();
+
+	for (u32 i = 0; i < AUDIO_SAMPLES; i += 4)
+	{
+		const __m128 v = _mm_loadu_ps(vol + i);
+		const __m128 s0 = _mm_mul_ps(audio_load_be(src + i * 2 + 0), _mm_unpacklo_ps(v, v));
+		const __m128 s1 = _mm_mul_ps(audio_load_be(src + i * 2 + 4), _mm_unpackhi_ps(v, v));
+
+		// Front channels of 4 frames in 8-channel layout
+		const __m128 f0 = _mm_movelh_ps(s0, zero);
+		const __m128 f1 = _mm_movehl_ps(zero, s0);
+		const __m128 f2 = _mm_movelh_ps(s1, zero);
+		const __m128 f3 = _mm_movehl_ps(zero, s1);
+
+		f32* out2 = buf2ch + i * 2;
+		f32* out8 = buf8ch + i * 8;
+
+		if (First)
+		{
+			_mm_store_ps(out2 + 0, s0);
+			_mm_store_ps(out2 + 4, s1);
+			_mm_store_ps(out8 + 0, f0);
+			_mm_store_ps(out8 + 4, zero);
+			_mm_store_ps(out8 + 8, f1);
+			_mm_store_ps(out8 + 12, zero);
+			_mm_store_ps(out8 + 16, f2);
+			_mm_store_ps(out8 + 20, zero);
+			_mm_store_ps(out8 + 24, f3);
+			_mm_store_ps(out8 + 28, zero);
+		}
+		else
+		{
+			_mm_store_ps(out2 + 0, _mm_add_ps(_mm_load_ps(out2 + 0), s0));
+			_mm_store_ps(out2 + 4, _mm_add_ps(_mm_load_ps(out2 + 4), s1));
+			_mm_store_ps(out8 + 0, _mm_add_ps(_mm_load_ps(out8 + 0), f0));
+			_mm_store_ps(out8 + 8, _mm_add_ps(_mm_load_ps(out8 + 8), f1));
+			_mm_store_ps(out8 + 16, _mm_add_ps(_mm_load_ps(out8 + 16), f2));
+			_mm_store_ps(out8 + 24, _mm_add_ps(_mm_load_ps(out8 + 24), f3));
+		}
+	}
+}
+
+// Mix 8-channel port block with downmix to 2 channels
+template <bool First>
+static void audio_mix_8ch(const be_t<f32>* src, const f32* vol, f32* buf2ch, f32* buf8ch)
+{
+	const __m128 mid_k = _mm_set1_ps(0.708f);
+
+	// Returns {L + RL + SL + mid, R + RR + SR + mid, ?, ?}
+	auto downmix = [&](__m128 front, __m128 rear)
+	{
+		const __m128 lr = _mm_add_ps(_mm_add_ps(front, rear), _mm_movehl_ps(rear, rear));
+		const __m128 mid = _mm_add_ps(_mm_shuffle_ps(front, front, 0xaa), _mm_shuffle_ps(front, front, 0xff));
+		return _mm_add_ps(lr, _mm_mul_ps(mid, mid_k));
+	};
+
+	for (u32 i = 0; i < AUDIO_SAMPLES; i += 2)
+	{
+		const __m128 v0 = _mm_set1_ps(vol[i + 0]);
+		const __m128 v1 = _mm_set1_ps(vol[i + 1]);
+
+		// L, R, C, LFE and RL, RR, SL, SR of 2 frames
+		const __m128 a0 = _mm_mul_ps(audio_load_be(src + i * 8 + 0), v0);
+		const __m128 b0 = _mm_mul_ps(audio_load_be(src + i * 8 + 4), v0);
+		const __m128 a1 = _mm_mul_ps(audio_load_be(src + i * 8 + 8), v1);
+		const __m128 b1 = _mm_mul_ps(audio_load_be(src + i * 8 + 12), v1);
+
+		const __m128 d = _mm_movelh_ps(downmix(a0, b0), downmix(a1, b1));
+
+		f32* out2 = buf2ch + i * 2;
+		f32* out8 = buf8ch + i * 8;
+
+		if (First)
+		{
+			_mm_store_ps(out2, d);
+			_mm_store_ps(out8 + 0, a0);
+			_mm_store_ps(out8 + 4, b0);
+			_mm_store_ps(out8 + 8, a1);
+			_mm_store_ps(out8 + 12, b1);
+		}
+		else
+		{
+			_mm_store_ps(out2, _mm_add_ps(_mm_load_ps(out2), d));
+			_mm_store_ps(out8 + 0, _mm_add_ps(_mm_load_ps(out8 + 0), a0));
+			_mm_store_ps(out8 + 4, _mm_add_ps(_mm_load_ps(out8 + 4), b0));
+			_mm_store_ps(out8 + 8, _mm_add_ps(_mm_load_ps(out8 + 8), a1));
+			_mm_store_ps(out8 + 12, _mm_add_ps(_mm_load_ps(out8 + 12), b1));
+		}
+	}
+}
+
 void audio_config::on_task()
 {
 	thread_ctrl::set_native_priority(1);
 
 	AudioDumper m_dump(g_cfg.audio.dump_to_file ? 2 : 0); // Init AudioDumper for 2 channels if enabled
 
-	float buf2ch[2 * BUFFER_SIZE]{}; // intermediate buffer for 2 channels
-	float buf8ch[8 * BUFFER_SIZE]{}; // intermediate buffer for 8 channels
+	alignas(16) float buf2ch[2 * BUFFER_SIZE]{}; // intermediate buffer for 2 channels
+	alignas(16) float buf8ch[8 * BUFFER_SIZE]{}; // intermediate buffer for 8 channels
+	alignas(16) float volume[AUDIO_SAMPLES]; // port volume for each sample frame
 
 	const u32 buf_sz = BUFFER_SIZE * (g_cfg.audio.convert_to_u16 ? 2 : 4) * (g_cfg.audio.downmix_to_2ch ? 2 : 8);
 
@@ -80,7 +184,7 @@ void audio_config::on_task()
 	{
 		if (Emu.IsPaused())
 		{
-			std::this_thread::sleep_for(1ms); // hack
+			thread_ctrl::wait_for(1000);
 			continue;
 		}
 
@@ -94,10 +198,14 @@ void audio_config::on_task()
 		const u64 expected_time = m_counter * AUDIO_SAMPLES * 1000000 / 48000;
 		if (expected_time >= time_pos)
 		{
-			std::this_thread::sleep_for(1ms); // hack
+			// Sleep until the deadline of the next period
+			thread_ctrl::wait_for(expected_time - time_pos + 1);
 			continue;
 		}
 
+		// Lateness of the period
+		const u64 jitter = time_pos - expected_time;
+
 		m_counter++;
 
 		const u32 out_pos = m_counter % BUFFER_NUM;
@@ -115,129 +223,55 @@ void audio_config::on_task()
 
 			auto buf = vm::_ptr<f32>(buf_addr);
 
-			static const float k = 1.0f; // may be 1.0f
-			const float& m = port.level;
-
-			auto step_volume = [](audio_port& port) // part of cellAudioSetPortLevel functionality
+			// Compute volume for each sample frame (part of cellAudioSetPortLevel functionality)
+			if (port.level_set.load().inc != 0.0f)
 			{
-				const auto param = port.level_set.load();
-
-				if (param.inc != 0.0f)
+				for (u32 i = 0; i < AUDIO_SAMPLES; i++)
 				{
-					port.level += param.inc;
-					const bool dec = param.inc < 0.0f;
+					const auto param = port.level_set.load();
 
-					if ((!dec && param.value - port.level <= 0.0f) || (dec && param.value - port.level >= 0.0f))
+					if (param.inc != 0.0f)
 					{
-						port.level = param.value;
-						port.level_set.compare_and_swap(param, { param.value, 0.0f });
+						port.level += param.inc;
+						const bool dec = param.inc < 0.0f;
+
+						if ((!dec && param.value - port.level <= 0.0f) || (dec && param.value - port.level >= 0.0f))
+						{
+							port.level = param.value;
+							port.level_set.compare_and_swap(param, { param.value, 0.0f });
+						}
 					}
+
+					volume[i] = port.level;
 				}
-			};
+			}
+			else
+			{
+				std::fill_n(volume, AUDIO_SAMPLES, port.level);
+			}
 
 			if (port.channel == 2)
 			{
 				if (first_mix)
 				{
-					for (u32 i = 0; i < (sizeof(buf2ch) / sizeof(float)); i += 2)
-					{
-						step_volume(port);
-
-						// reverse byte order
-						const float left = buf[i + 0] * m;
-						const float right = buf[i + 1] * m;
-
-						buf2ch[i + 0] = left;
-						buf2ch[i + 1] = right;
-
-						buf8ch[i * 4 + 0] = left;
-						buf8ch[i * 4 + 1] = right;
-						buf8ch[i * 4 + 2] = 0.0f;
-						buf8ch[i * 4 + 3] = 0.0f;
-						buf8ch[i * 4 + 4] = 0.0f;
-						buf8ch[i * 4 + 5] = 0.0f;
-						buf8ch[i * 4 + 6] = 0.0f;
-						buf8ch[i * 4 + 7] = 0.0f;
-					}
+					audio_mix_2ch<true>(buf, volume, buf2ch, buf8ch);
 					first_mix = false;
 				}
 				else
 				{
-					for (u32 i = 0; i < (sizeof(buf2ch) / sizeof(float)); i += 2)
-					{
-						step_volume(port);
-
-						const float left = buf[i + 0] * m;
-						const float right = buf[i + 1] * m;
-
-						buf2ch[i + 0] += left;
-						buf2ch[i + 1] += right;
-
-						buf8ch[i * 4 + 0] += left;
-						buf8ch[i * 4 + 1] += right;
-					}
+					audio_mix_2ch<false>(buf, volume, buf2ch, buf8ch);
 				}
 			}
 			else if (port.channel == 8)
 			{
 				if (first_mix)
 				{
-					for (u32 i = 0; i < (sizeof(buf2ch) / sizeof(float)); i += 2)
-					{
-						step_volume(port);
-
-						const float left = buf[i * 4 + 0] * m;
-						const float right = buf[i * 4 + 1] * m;
-						const float center = buf[i * 4 + 2] * m;
-						const float low_freq = buf[i * 4 + 3] * m;
-						const float rear_left = buf[i * 4 + 4] * m;
-						const float rear_right = buf[i * 4 + 5] * m;
-						const float side_left = buf[i * 4 + 6] * m;
-						const float side_right = buf[i * 4 + 7] * m;
-
-						const float mid = (center + low_freq) * 0.708f;
-						buf2ch[i + 0] = (left + rear_left + side_left + mid) * k;
-						buf2ch[i + 1] = (right + rear_right + side_right + mid) * k;
-
-						buf8ch[i * 4 + 0] = left;
-						buf8ch[i * 4 + 1] = right;
-						buf8ch[i * 4 + 2] = center;
-						buf8ch[i * 4 + 3] = low_freq;
-						buf8ch[i * 4 + 4] = rear_left;
-						buf8ch[i * 4 + 5] = rear_right;
-						buf8ch[i * 4 + 6] = side_left;
-						buf8ch[i * 4 + 7] = side_right;
-					}
+					audio_mix_8ch<true>(buf, volume, buf2ch, buf8ch);
 					first_mix = false;
 				}
 				else
 				{
-					for (u32 i = 0; i < (sizeof(buf2ch) / sizeof(float)); i += 2)
-					{
-						step_volume(port);
-
-						const float left = buf[i * 4 + 0] * m;
-						const float right = buf[i * 4 + 1] * m;
-						const float center = buf[i * 4 + 2] * m;
-						const float low_freq = buf[i * 4 + 3] * m;
-						const float rear_left = buf[i * 4 + 4] * m;
-						const float rear_right = buf[i * 4 + 5] * m;
-						const float side_left = buf[i * 4 + 6] * m;
-						const float side_right = buf[i * 4 + 7] * m;
-
-						const float mid = (center + low_freq) * 0.708f;
-						buf2ch[i + 0] += (left + rear_left + side_left + mid) * k;
-						buf2ch[i + 1] += (right + rear_right + side_right + mid) * k;
-
-						buf8ch[i * 4 + 0] += left;
-						buf8ch[i * 4 + 1] += right;
-						buf8ch[i * 4 + 2] += center;
-						buf8ch[i * 4 + 3] += low_freq;
-						buf8ch[i * 4 + 4] += rear_left;
-						buf8ch[i * 4 + 5] += rear_right;
-						buf8ch[i * 4 + 6] += side_left;
-						buf8ch[i * 4 + 7] += side_right;
-					}
+					audio_mix_8ch<false>(buf, volume, buf2ch, buf8ch);
 				}
 			}
 			else
@@ -254,17 +288,11 @@ void audio_config::on_task()
 			// Copy output data (2ch or 8ch)
 			if (g_cfg.audio.downmix_to_2ch)
 			{
-				for (u32 i = 0; i < (sizeof(buf2ch) / sizeof(float)); i++)
-				{
-					out_buffer[out_pos][i] = buf2ch[i];
-				}
+				std::memcpy(out_buffer[out_pos].get(), buf2ch, sizeof(buf2ch));
 			}
 			else
 			{
-				for (u32 i = 0; i < (sizeof(buf8ch) / sizeof(float)); i++)
-				{
-					out_buffer[out_pos][i] = buf8ch[i];
-				}
+				std::memcpy(out_buffer[out_pos].get(), buf8ch, sizeof(buf8ch));
 			}
 		}
 
@@ -286,12 +314,15 @@ void audio_config::on_task()
 
 			__m128i buf_u16[BUFFER_SIZE];
 
-			for (size_t i = 0; i < 8 * BUFFER_SIZE; i += 8)
+			const auto scale = _mm_set1_ps(0x8000);
+			const f32* src = out_buffer[out_pos].get();
+
+			// Only convert the samples which are going to be output
+			for (u32 i = 0; i < buf_sz / sizeof(u16); i += 8)
 			{
-				const auto scale = _mm_set1_ps(0x8000);
 				buf_u16[i / 8] = _mm_packs_epi32(
-					_mm_cvtps_epi32(_mm_mul_ps(_mm_load_ps(out_buffer[out_pos].get() + i), scale)),
-					_mm_cvtps_epi32(_mm_mul_ps(_mm_load_ps(out_buffer[out_pos].get() + i + 4), scale)));
+					_mm_cvtps_epi32(_mm_mul_ps(_mm_load_ps(src + i), scale)),
+					_mm_cvtps_epi32(_mm_mul_ps(_mm_load_ps(src + i + 4), scale)));
 			}
 
 			audio->AddData(buf_u16, buf_sz);
@@ -339,8 +370,21 @@ void audio_config::on_task()
 		case 8: m_dump.WriteData(&buf8ch, sizeof(buf8ch)); break; // write file data (8 ch)
 		}
 
-		cellAudio.trace("Audio perf: (access=%d, AddData=%d, events=%d, dump=%d)",
-			stamp1 - stamp0, stamp2 - stamp1, stamp3 - stamp2, get_system_time() - stamp3);
+		// Update metrics
+		metrics.periods++;
+		metrics.jitter_sum += jitter;
+		metrics.jitter_max = std::max(metrics.jitter_max, jitter);
+		metrics.mix_sum += stamp1 - stamp0;
+		metrics.mix_max = std::max(metrics.mix_max, stamp1 - stamp0);
+
+		cellAudio.trace("Audio perf: (jitter=%d, access=%d, AddData=%d, events=%d, dump=%d)",
+			jitter, stamp1 - stamp0, stamp2 - stamp1, stamp3 - stamp2, get_system_time() - stamp3);
+	}
+
+	if (metrics.periods)
+	{
+		cellAudio.notice("Audio perf: %u periods, jitter avg=%uus max=%uus, mixing avg=%uus max=%uus", metrics.periods,
+			metrics.jitter_sum / metrics.periods, metrics.jitter_max, metrics.mix_sum / metrics.periods, metrics.mix_max);
 	}
 }
 
@@ -137,6 +137,16 @@ public:
 
 	std::array<audio_port, AUDIO_PORT_COUNT> ports;
 
+	// Mixing period statistics (microseconds)
+	struct
+	{
+		u64 periods = 0;
+		u64 jitter_sum = 0; // Lateness relative to the period deadline
+		u64 jitter_max = 0;
+		u64 mix_sum = 0; // Time spent mixing ports
+		u64 mix_max = 0;
+	} metrics;
+
 	std::vector<u64> keys;
 
 	semaphore<> mutex;
@@ -7,6 +7,8 @@
 #include "cellPamf.h"
 #include "cellDmux.h"
 
+#include "Utilities/cond.h"
+
 #include <thread>
 
 logs::channel cellDmux("cellDmux");
@@ -130,6 +132,66 @@ struct DemuxerTask
 	}
 };
 
+// Fixed-size ring buffer for demultiplexed ES data
+class es_ring_buffer
+{
+	std::unique_ptr<u8[]> m_data;
+	u32 m_head = 0; // Read position
+	u32 m_size = 0; // Amount of stored data
+
+public:
+	static const u32 capacity = 0x200000;
+
+	es_ring_buffer()
+		: m_data(new u8[capacity])
+	{
+	}
+
+	u32 size() const
+	{
+		return m_size;
+	}
+
+	// Append data
+	void push(const u8* src, u32 size)
+	{
+		verify(HERE), size <= capacity - m_size;
+
+		const u32 tail = (m_head + m_size) % capacity;
+		const u32 part = std::min(size, capacity - tail);
+
+		std::memcpy(m_data.get() + tail, src, part);
+		std::memcpy(m_data.get(), src + part, size - part);
+		m_size += size;
+	}
+
+	// Copy data from the beginning without removing it
+	void read(u8* dst, u32 size) const
+	{
+		verify(HERE), size <= m_size;
+
+		const u32 part = std::min(size, capacity - m_head);
+
+		std::memcpy(dst, m_data.get() + m_head, part);
+		std::memcpy(dst + part, m_data.get(), size - part);
+	}
+
+	// Remove data from the beginning
+	void pop(u32 size)
+	{
+		verify(HERE), size <= m_size;
+
+		m_head = (m_head + size) % capacity;
+		m_size -= size;
+	}
+
+	void clear()
+	{
+		m_head = 0;
+		m_size = 0;
+	}
+};
+
 class ElementaryStream
 {
 	std::mutex m_mutex;
@@ -162,8 +224,7 @@ public:
 	const u32 cbArg;
 	const u32 spec; //addr
 
-	std::vector<u8> raw_data; // demultiplexed data stream (managed by demuxer thread)
-	size_t raw_pos; // should be <= raw_data.size()
+	es_ring_buffer raw_data; // demultiplexed data stream (managed by demuxer thread)
 	u64 last_dts;
 	u64 last_pts;
 
@@ -193,6 +254,10 @@ public:
 	atomic_t<bool> is_running;
 	atomic_t<bool> is_working;
 
+	// Signaled when is_working is cleared or is_finished is set
+	std::mutex done_mutex;
+	cond_variable done_cv;
+
 	Demuxer(u32 addr, u32 size, vm::ptr<CellDmuxCbMsg> func, u32 arg)
 		: ppu_thread("HLE Demuxer")
 		, is_finished(false)
@@ -206,6 +271,26 @@ public:
 	{
 	}
 
+	// Add task and wake up the demuxer thread (it may be waiting for ES buffer space)
+	bool push_task(const DemuxerTask& task)
+	{
+		const bool result = job.push(task, &is_closed);
+		notify();
+		return result;
+	}
+
+	// Update the flag and wake up waiting threads
+	template <typename T>
+	void set_done(T& flag, bool value)
+	{
+		{
+			std::lock_guard<std::mutex> lock(done_mutex);
+			flag = value;
+		}
+
+		done_cv.notify_all();
+	}
+
 	virtual void cpu_task() override
 	{
 		DemuxerTask task;
@@ -245,7 +330,7 @@ public:
 					cbFunc(*this, id, dmuxMsg, cbArg);
 					lv2_obj::sleep(*this);
 
-					is_working = false;
+					set_done(is_working, false);
 
 					stream = {};
 					
@@ -351,8 +436,9 @@ public:
 						ElementaryStream& es = *esATX[ch];
 						if (es.raw_data.size() > 1024 * 1024)
 						{
+							// Wait for released AU or new task
 							stream = backup;
-							std::this_thread::sleep_for(1ms); // hack
+							thread_ctrl::wait();
 							continue;
 						}
 
@@ -373,11 +459,13 @@ public:
 
 						while (true)
 						{
-							auto const size = es.raw_data.size() - es.raw_pos; // size of available new data
-							auto const data = es.raw_data.data() + es.raw_pos; // pointer to available data
+							const u32 size = es.raw_data.size(); // size of available new data
 
 							if (size < 8) break; // skip if cannot read ATS header
 
+							u8 data[8];
+							es.raw_data.read(data, 8);
+
 							if (data[0] != 0x0f || data[1] != 0xd0)
 							{
 								fmt::throw_exception("ATX: 0x0fd0 header not found (ats=0x%llx)" HERE, *(be_t<u64>*)data);
@@ -445,11 +533,12 @@ public:
 					{
 						ElementaryStream& es = *esAVC[ch];
 
-						const u32 old_size = (u32)es.raw_data.size();
+						const u32 old_size = es.raw_data.size();
 						if (es.isfull(old_size))
 						{
+							// Wait for released AU or new task
 							stream = backup;
-							std::this_thread::sleep_for(1ms); // hack
+							thread_ctrl::wait();
 							continue;
 						}
 
@@ -544,7 +633,7 @@ public:
 
 					stream = {};
 
-					is_working = false;
+					set_done(is_working, false);
 				}
 
 				break;
@@ -611,7 +700,7 @@ public:
 			{
 				ElementaryStream& es = *task.es.es_ptr;
 
-				const u32 old_size = (u32)es.raw_data.size();
+				const u32 old_size = es.raw_data.size();
 				if (old_size && (es.fidMajor & -0x10) == 0xe0)
 				{
 					// TODO (it's only for AVC, some ATX data may be lost)
@@ -619,7 +708,7 @@ public:
 					{
 						if (Emu.IsStopped() || is_closed) break;
 
-						std::this_thread::sleep_for(1ms); // hack
+						thread_ctrl::wait();
 					}
 
 					es.push_au(old_size, es.last_dts, es.last_pts, stream.userdata, false, 0);
@@ -634,7 +723,7 @@ public:
 				
 				if (es.raw_data.size())
 				{
-					cellDmux.error("dmuxFlushEs: 0x%x bytes lost (es_id=%d)", (u32)es.raw_data.size(), es.id);
+					cellDmux.error("dmuxFlushEs: 0x%x bytes lost (es_id=%d)", es.raw_data.size(), es.id);
 				}
 
 				// callback
@@ -664,7 +753,8 @@ public:
 			}
 		}
 
-		is_finished = true;
+		state += cpu_flag::exit;
+		set_done(is_finished, true);
 	}
 };
 
@@ -753,7 +843,6 @@ ElementaryStream::ElementaryStream(Demuxer* dmux, u32 addr, u32 size, u32 fidMaj
 	, put_count(0)
 	, got_count(0)
 	, released(0)
-	, raw_pos(0)
 	, last_dts(CODEC_TS_INVALID)
 	, last_pts(CODEC_TS_INVALID)
 {
@@ -810,8 +899,8 @@ void ElementaryStream::push_au(u32 size, u64 dts, u64 pts, u64 userdata, bool ra
 			put = memAddr;
 		}
 
-		std::memcpy(vm::base(put + 128), raw_data.data(), size);
-		raw_data.erase(raw_data.begin(), raw_data.begin() + size);
+		raw_data.read(vm::_ptr<u8>(put + 128), size);
+		raw_data.pop(size);
 
 		auto info = vm::ptr<CellDmuxAuInfoEx>::make(put);
 		info->auAddr = put + 128;
@@ -849,11 +938,7 @@ void ElementaryStream::push_au(u32 size, u64 dts, u64 pts, u64 userdata, bool ra
 
 void ElementaryStream::push(DemuxerStream& stream, u32 size)
 {
-	auto const old_size = raw_data.size();
-
-	raw_data.resize(old_size + size);
-
-	std::memcpy(raw_data.data() + old_size, vm::base(stream.addr), size); // append bytes
+	raw_data.push(vm::_ptr<u8>(stream.addr), size); // append bytes
 
 	stream.skip(size);
 }
@@ -883,6 +968,13 @@ bool ElementaryStream::release()
 	}
 
 	released++;
+
+	// Wake up the demuxer thread if it's waiting for space
+	if (dmux)
+	{
+		dmux->notify();
+	}
+
 	return true;
 }
 
@@ -927,7 +1019,6 @@ void ElementaryStream::reset()
 	got_count = 0;
 	released = 0;
 	raw_data.clear();
-	raw_pos = 0;
 }
 
 void dmuxQueryAttr(u32 info_addr /* may be 0 */, vm::ptr<CellDmuxAttr> attr)
@@ -1054,16 +1145,22 @@ s32 cellDmuxClose(u32 handle)
 
 	dmux->is_closed = true;
 	dmux->job.try_push(DemuxerTask(dmuxClose));
+	dmux->notify();
 
-	while (!dmux->is_finished)
 	{
-		if (Emu.IsStopped())
+		std::unique_lock<std::mutex> lock(dmux->done_mutex);
+
+		while (!dmux->is_finished)
 		{
-			cellDmux.warning("cellDmuxClose(%d) aborted", handle);
-			return CELL_OK;
-		}
+			if (Emu.IsStopped())
+			{
+				cellDmux.warning("cellDmuxClose(%d) aborted", handle);
+				return CELL_OK;
+			}
 
-		std::this_thread::sleep_for(1ms); // hack
+			// Timeout is only necessary to check emulation stop
+			dmux->done_cv.wait(lock, 100000);
+		}
 	}
 
 	idm::remove<ppu_thread>(handle);
@@ -1094,7 +1191,7 @@ s32 cellDmuxSetStream(u32 handle, u32 streamAddress, u32 streamSize, b8 disconti
 	info.discontinuity = discontinuity;
 	info.userdata = userData;
 
-	dmux->job.push(task, &dmux->is_closed);
+	dmux->push_task(task);
 	return CELL_OK;
 }
 
@@ -1109,7 +1206,7 @@ s32 cellDmuxResetStream(u32 handle)
 		return CELL_DMUX_ERROR_ARG;
 	}
 
-	dmux->job.push(DemuxerTask(dmuxResetStream), &dmux->is_closed);
+	dmux->push_task(DemuxerTask(dmuxResetStream));
 	return CELL_OK;
 }
 
@@ -1131,7 +1228,9 @@ s32 cellDmuxResetStreamAndWaitDone(u32 handle)
 
 	dmux->is_working = true;
 
-	dmux->job.push(DemuxerTask(dmuxResetStreamAndWaitDone), &dmux->is_closed);
+	dmux->push_task(DemuxerTask(dmuxResetStreamAndWaitDone));
+
+	std::unique_lock<std::mutex> lock(dmux->done_mutex);
 
 	while (dmux->is_running && dmux->is_working && !dmux->is_closed) // TODO: ensure that it is safe
 	{
@@ -1140,7 +1239,9 @@ s32 cellDmuxResetStreamAndWaitDone(u32 handle)
 			cellDmux.warning("cellDmuxResetStreamAndWaitDone(%d) aborted", handle);
 			return CELL_OK;
 		}
-		std::this_thread::sleep_for(1ms); // hack
+
+		// Timeout is only necessary to check emulation stop
+		dmux->done_cv.wait(lock, 100000);
 	}
 
 	return CELL_OK;
@@ -1200,7 +1301,7 @@ s32 cellDmuxEnableEs(u32 handle, vm::cptr<CellCodecEsFilterId> esFilterId, vm::c
 	task.es.es = es->id;
 	task.es.es_ptr = es.get();
 
-	dmux->job.push(task, &dmux->is_closed);
+	dmux->push_task(task);
 	return CELL_OK;
 }
 
@@ -1219,7 +1320,7 @@ s32 cellDmuxDisableEs(u32 esHandle)
 	task.es.es = esHandle;
 	task.es.es_ptr = es.get();
 
-	es->dmux->job.push(task, &es->dmux->is_closed);
+	es->dmux->push_task(task);
 	return CELL_OK;
 }
 
@@ -1238,7 +1339,7 @@ s32 cellDmuxResetEs(u32 esHandle)
 	task.es.es = esHandle;
 	task.es.es_ptr = es.get();
 
-	es->dmux->job.push(task, &es->dmux->is_closed);
+	es->dmux->push_task(task);
 	return CELL_OK;
 }
 
@@ -1367,7 +1468,7 @@ s32 cellDmuxFlushEs(u32 esHandle)
 	task.es.es = esHandle;
 	task.es.es_ptr = es.get();
 
-	es->dmux->job.push(task, &es->dmux->is_closed);
+	es->dmux->push_task(task);
 	return CELL_OK;
 }
 
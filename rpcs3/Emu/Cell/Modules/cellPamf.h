@@ -440,6 +440,30 @@ class squeue_t
 		SQSVR_FAILED = 2,
 	};
 
+	// Wait until the sync variable differs from the observed value
+	void wait_change(std::mutex& mutex, std::condition_variable& cv, const squeue_sync_var_t& old) const
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+
+		const squeue_sync_var_t sync = m_sync.load();
+
+		if (std::memcmp(&sync, &old, sizeof(old)) == 0)
+		{
+			// Changes are signaled under the mutex, timeout is only necessary to test exit conditions
+			cv.wait_for(lock, std::chrono::milliseconds(10));
+		}
+	}
+
+	// Signal state change (the mutex is acquired so that the notification can't be missed)
+	void notify_change(std::mutex& mutex, std::condition_variable& cv) const
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+		}
+
+		cv.notify_all();
+	}
+
 public:
 	squeue_t()
 		: m_sync(squeue_sync_var_t{})
@@ -460,9 +484,12 @@ public:
 	{
 		u32 pos = 0;
 
-		while (u32 res = m_sync.atomic_op([&pos](squeue_sync_var_t& sync) -> u32
+		squeue_sync_var_t old;
+
+		while (u32 res = m_sync.atomic_op([&pos, &old](squeue_sync_var_t& sync) -> u32
 		{
 			verify(HERE), sync.count <= sq_size, sync.position < sq_size;
+			old = sync;
 
 			if (sync.push_lock)
 			{
@@ -483,8 +510,7 @@ public:
 				return false;
 			}
 
-			std::unique_lock<std::mutex> wcv_lock(m_wcv_mutex);
-			m_wcv.wait_for(wcv_lock, std::chrono::milliseconds(1));
+			wait_change(m_wcv_mutex, m_wcv, old);
 		}
 
 		m_data[pos >= sq_size ? pos - sq_size : pos] = data;
@@ -496,8 +522,8 @@ public:
 			sync.count++;
 		});
 
-		m_rcv.notify_one();
-		m_wcv.notify_one();
+		notify_change(m_rcv_mutex, m_rcv);
+		notify_change(m_wcv_mutex, m_wcv);
 		return true;
 	}
 
@@ -520,9 +546,12 @@ public:
 	{
 		u32 pos = 0;
 
-		while (u32 res = m_sync.atomic_op([&pos](squeue_sync_var_t& sync) -> u32
+		squeue_sync_var_t old;
+
+		while (u32 res = m_sync.atomic_op([&pos, &old](squeue_sync_var_t& sync) -> u32
 		{
 			verify(HERE), sync.count <= sq_size, sync.position < sq_size;
+			old = sync;
 
 			if (!sync.count)
 			{
@@ -543,8 +572,7 @@ public:
 				return false;
 			}
 
-			std::unique_lock<std::mutex> rcv_lock(m_rcv_mutex);
-			m_rcv.wait_for(rcv_lock, std::chrono::milliseconds(1));
+			wait_change(m_rcv_mutex, m_rcv, old);
 		}
 
 		data = m_data[pos];
@@ -561,8 +589,8 @@ public:
 			}
 		});
 
-		m_rcv.notify_one();
-		m_wcv.notify_one();
+		notify_change(m_rcv_mutex, m_rcv);
+		notify_change(m_wcv_mutex, m_wcv);
 		return true;
 	}
 
@@ -586,9 +614,12 @@ public:
 		verify(HERE), start_pos < sq_size;
 		u32 pos = 0;
 
-		while (u32 res = m_sync.atomic_op([&pos, start_pos](squeue_sync_var_t& sync) -> u32
+		squeue_sync_var_t old;
+
+		while (u32 res = m_sync.atomic_op([&pos, &old, start_pos](squeue_sync_var_t& sync) -> u32
 		{
 			verify(HERE), sync.count <= sq_size, sync.position < sq_size;
+			old = sync;
 
 			if (sync.count <= start_pos)
 			{
@@ -609,8 +640,7 @@ public:
 				return false;
 			}
 
-			std::unique_lock<std::mutex> rcv_lock(m_rcv_mutex);
-			m_rcv.wait_for(rcv_lock, std::chrono::milliseconds(1));
+			wait_change(m_rcv_mutex, m_rcv, old);
 		}
 
 		data = m_data[pos >= sq_size ? pos - sq_size : pos];
@@ -621,7 +651,7 @@ public:
 			sync.pop_lock = 0;
 		});
 
-		m_rcv.notify_one();
+		notify_change(m_rcv_mutex, m_rcv);
 		return true;
 	}
 
@@ -667,9 +697,12 @@ public:
 	{
 		u32 pos, count;
 
-		while (m_sync.atomic_op([&pos, &count](squeue_sync_var_t& sync) -> u32
+		squeue_sync_var_t old;
+
+		while (m_sync.atomic_op([&pos, &count, &old](squeue_sync_var_t& sync) -> u32
 		{
 			verify(HERE), sync.count <= sq_size, sync.position < sq_size;
+			old = sync;
 
 			if (sync.pop_lock || sync.push_lock)
 			{
@@ -683,8 +716,7 @@ public:
 			return SQSVR_OK;
 		}))
 		{
-			std::unique_lock<std::mutex> rcv_lock(m_rcv_mutex);
-			m_rcv.wait_for(rcv_lock, std::chrono::milliseconds(1));
+			wait_change(m_rcv_mutex, m_rcv, old);
 		}
 
 		proc(squeue_data_t(m_data, pos, count));
@@ -696,15 +728,18 @@ public:
 			sync.push_lock = 0;
 		});
 
-		m_wcv.notify_one();
-		m_rcv.notify_one();
+		notify_change(m_wcv_mutex, m_wcv);
+		notify_change(m_rcv_mutex, m_rcv);
 	}
 
 	void clear()
 	{
-		while (m_sync.atomic_op([](squeue_sync_var_t& sync) -> u32
+		squeue_sync_var_t old;
+
+		while (m_sync.atomic_op([&old](squeue_sync_var_t& sync) -> u32
 		{
 			verify(HERE), sync.count <= sq_size, sync.position < sq_size;
+			old = sync;
 
 			if (sync.pop_lock || sync.push_lock)
 			{
@@ -716,12 +751,11 @@ public:
 			return SQSVR_OK;
 		}))
 		{
-			std::unique_lock<std::mutex> rcv_lock(m_rcv_mutex);
-			m_rcv.wait_for(rcv_lock, std::chrono::milliseconds(1));
+			wait_change(m_rcv_mutex, m_rcv, old);
 		}
 
 		m_sync.exchange({});
-		m_wcv.notify_one();
-		m_rcv.notify_one();
+		notify_change(m_wcv_mutex, m_wcv);
+		notify_change(m_rcv_mutex, m_rcv);
 	}
 };
@@ -18,6 +18,7 @@ extern "C"
 
 #include <mutex>
 #include <queue>
+#include <thread>
 #include <cmath>
 
 std::mutex g_mutex_avcodec_open2;
@@ -48,7 +49,9 @@ struct vdec_frame
 		}
 	};
 
-	std::unique_ptr<AVFrame, frame_dtor> avf;
+	using frame_ptr = std::unique_ptr<AVFrame, frame_dtor>;
+
+	frame_ptr avf;
 	u64 dts;
 	u64 pts;
 	u64 userdata;
@@ -83,6 +86,9 @@ struct vdec_thread : ppu_thread
 	std::queue<vdec_frame> out;
 	u32 max_frames = 60;
 
+	// Unreferenced frames available for reuse (protected by mutex)
+	std::vector<vdec_frame::frame_ptr> frame_pool;
+
 	atomic_t<u32> au_count{0};
 
 	vdec_thread(s32 type, u32 profile, u32 addr, u32 size, vm::ptr<CellVdecCbMsg> func, u32 arg, u32 prio, u32 stack)
@@ -131,6 +137,15 @@ struct vdec_thread : ppu_thread
 			fmt::throw_exception("avcodec_alloc_context3() failed (type=0x%x)" HERE, type);
 		}
 
+		// Enable frame/slice threading (frame threading delays output, remaining frames are drained on end_seq)
+		const u32 threads = g_cfg.core.vdec_threads ? g_cfg.core.vdec_threads : std::max<u32>(1, std::min<u32>(std::thread::hardware_concurrency() / 2, 4));
+
+		if (threads > 1)
+		{
+			ctx->thread_count = threads;
+			ctx->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+		}
+
 		AVDictionary* opts{};
 		av_dict_set(&opts, "refcounted_frames", "1", 0);
 
@@ -157,6 +172,48 @@ struct vdec_thread : ppu_thread
 		return ppu_thread::dump();
 	}
 
+	// Get unused frame from the pool or allocate new one
+	vdec_frame::frame_ptr alloc_frame()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+
+			if (!frame_pool.empty())
+			{
+				vdec_frame::frame_ptr result = std::move(frame_pool.back());
+				frame_pool.pop_back();
+				return result;
+			}
+		}
+
+		vdec_frame::frame_ptr result(av_frame_alloc());
+
+		if (!result)
+		{
+			fmt::throw_exception("av_frame_alloc() failed" HERE);
+		}
+
+		return result;
+	}
+
+	// Release picture data and return the frame to the pool
+	void recycle_frame(vdec_frame::frame_ptr&& frame)
+	{
+		if (!frame)
+		{
+			return;
+		}
+
+		av_frame_unref(frame.get());
+
+		std::lock_guard<std::mutex> lock(mutex);
+
+		if (frame_pool.size() < max_frames)
+		{
+			frame_pool.emplace_back(std::move(frame));
+		}
+	}
+
 	virtual void cpu_task() override
 	{
 		while (cmd64 cmd = cmd_wait())
@@ -181,8 +238,6 @@ struct vdec_thread : ppu_thread
 				AVPacket packet{};
 				packet.pos = -1;
 
-				u64 au_usrd{};
-
 				if (vcmd == vdec_cmd::decode)
 				{
 					const u32 au_mode = cmd.arg2<u32>();  // TODO
@@ -190,7 +245,7 @@ struct vdec_thread : ppu_thread
 					const u32 au_size = cmd_get(1).arg2<u32>();
 					const u64 au_pts = cmd_get(2).as<u64>();
 					const u64 au_dts = cmd_get(3).as<u64>();
-					au_usrd = cmd_get(4).as<u64>(); // TODO
+					const u64 au_usrd = cmd_get(4).as<u64>();
 					const u64 au_spec = cmd_get(5).as<u64>(); // Unused
 					cmd_pop(5);
 
@@ -209,6 +264,9 @@ struct vdec_thread : ppu_thread
 						next_dts = au_dts;
 					}
 
+					// Userdata follows the AU through frame threading and reordering to the picture it produces
+					ctx->reordered_opaque = static_cast<s64>(au_usrd);
+
 					ctx->skip_frame =
 						au_mode == CELL_VDEC_DEC_MODE_NORMAL ? AVDISCARD_DEFAULT :
 						au_mode == CELL_VDEC_DEC_MODE_B_SKIP ? AVDISCARD_NONREF : AVDISCARD_NONINTRA;
@@ -224,20 +282,18 @@ struct vdec_thread : ppu_thread
 					cellVdec.trace("End sequence...");
 				}
 
+				// Frame threading holds back decoded pictures which must be drained with empty packets
+				const bool drain = vcmd == vdec_cmd::end_seq && ctx->active_thread_type & FF_THREAD_FRAME;
+
 				while (max_frames)
 				{
-					if (vcmd == vdec_cmd::end_seq)
+					if (vcmd == vdec_cmd::end_seq && !drain)
 					{
 						break;
 					}
 
 					vdec_frame frame;
-					frame.avf.reset(av_frame_alloc());
-
-					if (!frame.avf)
-					{
-						fmt::throw_exception("av_frame_alloc() failed" HERE);
-					}
+					frame.avf = alloc_frame();
 
 					int got_picture = 0;
 
@@ -250,6 +306,7 @@ struct vdec_thread : ppu_thread
 
 					if (got_picture == 0)
 					{
+						recycle_frame(std::move(frame.avf));
 						break;
 					}
 
@@ -283,7 +340,7 @@ struct vdec_thread : ppu_thread
 
 						frame.pts = next_pts;
 						frame.dts = next_dts;
-						frame.userdata = au_usrd;
+						frame.userdata = static_cast<u64>(frame->reordered_opaque);
 
 						if (frc_set)
 						{
@@ -359,6 +416,12 @@ struct vdec_thread : ppu_thread
 					}
 				}
 
+				if (drain)
+				{
+					// Decoder can't accept new data after draining
+					avcodec_flush_buffers(ctx);
+				}
+
 				if (max_frames)
 				{
 					cb_func(*this, id, vcmd == vdec_cmd::decode ? CELL_VDEC_MSG_TYPE_AUDONE : CELL_VDEC_MSG_TYPE_SEQDONE, CELL_OK, cb_arg);
@@ -600,63 +663,63 @@ s32 cellVdecGetPicture(u32 handle, vm::cptr<CellVdecPicFormat> format, vm::ptr<u
 		const int w = frame->width;
 		const int h = frame->height;
 
-		AVPixelFormat out_f = AV_PIX_FMT_YUV420P;
-
-		std::unique_ptr<u8[]> alpha_plane;
-
-		switch (const u32 type = format->formatType)
-		{
-		case CELL_VDEC_PICFMT_ARGB32_ILV: out_f = AV_PIX_FMT_ARGB; alpha_plane.reset(new u8[w * h]); break;
-		case CELL_VDEC_PICFMT_RGBA32_ILV: out_f = AV_PIX_FMT_RGBA; alpha_plane.reset(new u8[w * h]); break;
-		case CELL_VDEC_PICFMT_UYVY422_ILV: out_f = AV_PIX_FMT_UYVY422; break;
-		case CELL_VDEC_PICFMT_YUV420_PLANAR: out_f = AV_PIX_FMT_YUV420P; break;
-
-		default:
-		{
-			fmt::throw_exception("Unknown formatType (%d)" HERE, type);
-		}
-		}
-
 		// TODO: color matrix
 		if (format->colorMatrixType & ~1)
 		{
 			fmt::throw_exception("Unknown colorMatrixType (%d)" HERE, format->colorMatrixType);
 		}
 
-		if (alpha_plane)
+		if (frame->format != AV_PIX_FMT_YUV420P)
 		{
-			std::memset(alpha_plane.get(), format->alpha, w * h);
+			fmt::throw_exception("Unknown format (%d)" HERE, frame->format);
 		}
 
-		AVPixelFormat in_f = AV_PIX_FMT_YUV420P;
+		u8* const out = outBuff.get_ptr();
 
-		switch (frame->format)
+		switch (const u32 type = format->formatType)
 		{
-		case AV_PIX_FMT_YUV420P: in_f = alpha_plane ? AV_PIX_FMT_YUVA420P : AV_PIX_FMT_YUV420P; break;
-
-		default:
+		case CELL_VDEC_PICFMT_ARGB32_ILV:
+		case CELL_VDEC_PICFMT_RGBA32_ILV:
 		{
-			fmt::throw_exception("Unknown format (%d)" HERE, frame->format);
-		}
-		}
+			const AVPixelFormat out_f = type == CELL_VDEC_PICFMT_ARGB32_ILV ? AV_PIX_FMT_ARGB : AV_PIX_FMT_RGBA;
+
+			std::unique_ptr<u8[]> alpha_plane(new u8[w * h]);
+			std::memset(alpha_plane.get(), format->alpha, w * h);
+
+			vdec->sws = sws_getCachedContext(vdec->sws, w, h, AV_PIX_FMT_YUVA420P, w, h, out_f, SWS_POINT, NULL, NULL, NULL);
 
-		vdec->sws = sws_getCachedContext(vdec->sws, w, h, in_f, w, h, out_f, SWS_POINT, NULL, NULL, NULL);
+			u8* in_data[4] = { frame->data[0], frame->data[1], frame->data[2], alpha_plane.get() };
+			int in_line[4] = { frame->linesize[0], frame->linesize[1], frame->linesize[2], w * 1 };
+			u8* out_data[4] = { out };
+			int out_line[4] = { w * 4 };
+
+			sws_scale(vdec->sws, in_data, in_line, 0, h, out_data, out_line);
+			break;
+		}
+		case CELL_VDEC_PICFMT_UYVY422_ILV:
+		{
+			vdec->sws = sws_getCachedContext(vdec->sws, w, h, AV_PIX_FMT_YUV420P, w, h, AV_PIX_FMT_UYVY422, SWS_POINT, NULL, NULL, NULL);
 
-		u8* in_data[4] = { frame->data[0], frame->data[1], frame->data[2], alpha_plane.get() };
-		int in_line[4] = { frame->linesize[0], frame->linesize[1], frame->linesize[2], w * 1 };
-		u8* out_data[4] = { outBuff.get_ptr() };
-		int out_line[4] = { w * 4 };
+			u8* out_data[4] = { out };
+			int out_line[4] = { w * 2 };
 
-		if (!alpha_plane)
+			sws_scale(vdec->sws, frame->data, frame->linesize, 0, h, out_data, out_line);
+			break;
+		}
+		case CELL_VDEC_PICFMT_YUV420_PLANAR:
 		{
-			out_data[1] = out_data[0] + w * h;
-			out_data[2] = out_data[0] + w * h * 5 / 4;
-			out_line[0] = w;
-			out_line[1] = w / 2;
-			out_line[2] = w / 2;
+			// Same format: copy planes
+			av_image_copy_plane(out, w, frame->data[0], frame->linesize[0], w, h);
+			av_image_copy_plane(out + w * h, w / 2, frame->data[1], frame->linesize[1], w / 2, h / 2);
+			av_image_copy_plane(out + w * h * 5 / 4, w / 2, frame->data[2], frame->linesize[2], w / 2, h / 2);
+			break;
 		}
 
-		sws_scale(vdec->sws, in_data, in_line, 0, h, out_data, out_line);
+		default:
+		{
+			fmt::throw_exception("Unknown formatType (%d)" HERE, type);
+		}
+		}
 
 		//const u32 buf_size = align(av_image_get_buffer_size(vdec->ctx->pix_fmt, vdec->ctx->width, vdec->ctx->height, 1), 128);
 
@@ -669,6 +732,8 @@ s32 cellVdecGetPicture(u32 handle, vm::cptr<CellVdecPicFormat> format, vm::ptr<u
 		//}
 	}
 
+	vdec->recycle_frame(std::move(frame.avf));
+
 	return CELL_OK;
 }
 
@@ -4,6 +4,7 @@
 #include "PPUAnalyser.h"
 
 #include <unordered_set>
+#include <thread>
 
 #include "yaml-cpp/yaml.h"
 
@@ -521,6 +522,71 @@ namespace ppu_patterns
 	};
 }
 
+extern u64 get_system_time();
+
+// Split [0, count) into ranges (at least min_count items each) and call func(index, from, to) for each range on worker threads
+// Returns the number of ranges
+template <typename F>
+static u32 ppu_parallel_for(u32 count, u32 min_count, F&& func)
+{
+	const u32 threads = std::max<u32>(1, std::min<u32>(std::thread::hardware_concurrency(), count / min_count));
+
+	if (threads == 1)
+	{
+		func(0, 0, count);
+		return 1;
+	}
+
+	std::vector<std::shared_ptr<thread_ctrl>> workers(threads - 1);
+
+	for (u32 i = 1; i < threads; i++)
+	{
+		const u32 from = static_cast<u32>(u64{count} * i / threads);
+		const u32 to = static_cast<u32>(u64{count} * (i + 1) / threads);
+
+		thread_ctrl::spawn(workers[i - 1], "PPU Analyser Worker", [&func, i, from, to]()
+		{
+			func(i, from, to);
+		});
+	}
+
+	// First range is processed by the current thread
+	func(0, 0, static_cast<u32>(u64{count} / threads));
+
+	for (auto& worker : workers)
+	{
+		worker->join();
+	}
+
+	return threads;
+}
+
+// Scan memory range [addr, addr + size) word by word in parallel, func(from, to, out) collects values for its chunk
+// Results are concatenated in chunk order, so they don't depend on the number of threads
+template <typename F>
+static std::vector<u32> ppu_scan_parallel(u32 addr, u32 size, u64& time, F func)
+{
+	const u64 start_time = get_system_time();
+
+	// At least 1 MiB per thread
+	std::vector<std::vector<u32>> results(std::max<u32>(1, std::thread::hardware_concurrency()));
+
+	const u32 chunks = ppu_parallel_for(size / 4, 0x40000, [&](u32 index, u32 from, u32 to)
+	{
+		func(addr + from * 4, to == size / 4 ? addr + size : addr + to * 4, results[index]);
+	});
+
+	std::vector<u32> result;
+
+	for (u32 i = 0; i < chunks; i++)
+	{
+		result.insert(result.end(), results[i].begin(), results[i].end());
+	}
+
+	time += get_system_time() - start_time;
+	return result;
+}
+
 void ppu_module::analyse(u32 lib_toc, u32 entry)
 {
 	// Assume first segment is executable
@@ -536,6 +602,10 @@ void ppu_module::analyse(u32 lib_toc, u32 entry)
 	// Function analysis workload
 	std::vector<std::reference_wrapper<ppu_function>> func_queue;
 
+	// Time spent in full-image scans (profiling)
+	const u64 start_time = get_system_time();
+	u64 scan_time = 0;
+
 	// Known references (within segs, addr and value alignment = 4)
 	std::set<u32> addr_heap{entry};
 
@@ -585,15 +655,34 @@ void ppu_module::analyse(u32 lib_toc, u32 entry)
 		// Grope for OPD section (TODO: optimization, better constraints)
 		for (const auto& seg : segs)
 		{
-			for (vm::cptr<u32> ptr = vm::cast(seg.addr); ptr.addr() < seg.addr + seg.size; ptr++)
+			// Find candidates in parallel
+			const auto found = ppu_scan_parallel(seg.addr, seg.size, scan_time, [&](u32 from, u32 to, std::vector<u32>& out)
 			{
-				if (ptr[0] >= start && ptr[0] < end && ptr[0] % 4 == 0 && ptr[1] == toc)
+				for (vm::cptr<u32> ptr = vm::cast(from); ptr.addr() < to; ptr++)
 				{
-					// New function
-					LOG_TRACE(PPU, "OPD*: [0x%x] 0x%x (TOC=0x%x)", ptr, ptr[0], ptr[1]);
-					add_func(*ptr, addr_heap.count(ptr.addr()) ? toc : 0, 0);
-					ptr++;
+					if (ptr[0] >= start && ptr[0] < end && ptr[0] % 4 == 0 && ptr[1] == toc)
+					{
+						out.emplace_back(ptr.addr());
+					}
 				}
+			});
+
+			// Register them in address order, the word after each accepted entry is skipped
+			u32 skip = 0;
+
+			for (const u32 addr : found)
+			{
+				if (addr == skip && skip)
+				{
+					continue;
+				}
+
+				const vm::cptr<u32> ptr = vm::cast(addr);
+
+				// New function
+				LOG_TRACE(PPU, "OPD*: [0x%x] 0x%x (TOC=0x%x)", ptr, ptr[0], ptr[1]);
+				add_func(*ptr, addr_heap.count(addr) ? toc : 0, 0);
+				skip = addr + 4;
 			}
 		}
 	};
@@ -615,24 +704,29 @@ void ppu_module::analyse(u32 lib_toc, u32 entry)
 	// Find references indiscriminately
 	for (const auto& seg : segs)
 	{
-		for (vm::cptr<u32> ptr = vm::cast(seg.addr); ptr.addr() < seg.addr + seg.size; ptr++)
+		const auto refs = ppu_scan_parallel(seg.addr, seg.size, scan_time, [&](u32 from, u32 to, std::vector<u32>& out)
 		{
-			const u32 value = *ptr;
-
-			if (value % 4)
+			for (vm::cptr<u32> ptr = vm::cast(from); ptr.addr() < to; ptr++)
 			{
-				continue;
-			}
+				const u32 value = *ptr;
 
-			for (const auto& _seg : segs)
-			{
-				if (value >= _seg.addr && value < _seg.addr + _seg.size)
+				if (value % 4)
 				{
-					addr_heap.emplace(value);
-					break;
+					continue;
+				}
+
+				for (const auto& _seg : segs)
+				{
+					if (value >= _seg.addr && value < _seg.addr + _seg.size)
+					{
+						out.emplace_back(value);
+						break;
+					}
 				}
 			}
-		}
+		});
+
+		addr_heap.insert(refs.begin(), refs.end());
 	}
 
 	// Find OPD section
@@ -1321,93 +1415,110 @@ void ppu_module::analyse(u32 lib_toc, u32 entry)
 	}
 
 	// Function shrinkage, disabled (TODO: it's potentially dangerous but improvable)
+	// Functions are processed in parallel: each one only modifies itself and reads the addresses of others
+	std::vector<std::pair<const u32, ppu_function>*> fvec;
+	fvec.reserve(fmap.size());
+
 	for (auto& _pair : fmap)
 	{
-		auto& func = _pair.second;
-
-		// Get next function addr
-		const auto _next = fmap.lower_bound(_pair.first + 1);
+		fvec.emplace_back(&_pair);
+	}
 
-		const u32 next = _next == fmap.end() ? end : _next->first;
+	const u64 gap_start = get_system_time();
 
-		// Just ensure that functions don't overlap
-		if (func.addr + func.size > next)
+	ppu_parallel_for(::size32(fvec), 0x1000, [&](u32, u32 from, u32 to)
+	{
+		for (u32 index = from; index < to; index++)
 		{
-			LOG_WARNING(PPU, "Function overlap: [0x%x] 0x%x -> 0x%x", func.addr, func.size, next - func.addr);
-			continue; //func.size = next - func.addr;
+			auto& _pair = *fvec[index];
+			auto& func = _pair.second;
 
-			// Also invalidate blocks
-			for (auto& block : func.blocks)
+			// Get next function addr
+			const auto _next = fmap.lower_bound(_pair.first + 1);
+
+			const u32 next = _next == fmap.end() ? end : _next->first;
+
+			// Just ensure that functions don't overlap
+			if (func.addr + func.size > next)
 			{
-				if (block.first + block.second > next)
+				LOG_WARNING(PPU, "Function overlap: [0x%x] 0x%x -> 0x%x", func.addr, func.size, next - func.addr);
+				continue; //func.size = next - func.addr;
+
+				// Also invalidate blocks
+				for (auto& block : func.blocks)
 				{
-					block.second = block.first >= next ? 0 : next - block.first;
+					if (block.first + block.second > next)
+					{
+						block.second = block.first >= next ? 0 : next - block.first;
+					}
 				}
 			}
-		}
 
-		// Suspicious block start
-		u32 start = func.addr + func.size;
+			// Suspicious block start
+			u32 start = func.addr + func.size;
 
-		if (next == end)
-		{
-			continue;
-		}
-
-		// Analyse gaps between functions
-		for (vm::cptr<u32> _ptr = vm::cast(start); _ptr.addr() < next;)
-		{
-			const u32 addr = _ptr.addr();
-			const ppu_opcode_t op{*_ptr++};
-			const ppu_itype::type type = s_ppu_itype.decode(op.opcode);
-
-			if (type == ppu_itype::UNK)
+			if (next == end)
 			{
-				break;
+				continue;
 			}
-			else if (addr == start && op.opcode == ppu_instructions::NOP())
+
+			// Analyse gaps between functions
+			for (vm::cptr<u32> _ptr = vm::cast(start); _ptr.addr() < next;)
 			{
-				if (start == func.addr + func.size)
+				const u32 addr = _ptr.addr();
+				const ppu_opcode_t op{*_ptr++};
+				const ppu_itype::type type = s_ppu_itype.decode(op.opcode);
+
+				if (type == ppu_itype::UNK)
 				{
-					// Extend function with tail NOPs (hack)
-					func.size += 4;
+					break;
 				}
+				else if (addr == start && op.opcode == ppu_instructions::NOP())
+				{
+					if (start == func.addr + func.size)
+					{
+						// Extend function with tail NOPs (hack)
+						func.size += 4;
+					}
 
-				start += 4;
-				continue;
-			}
-			else if (type == ppu_itype::SC && op.opcode != ppu_instructions::SC(0))
-			{
-				break;
-			}
-			else if (addr == start && op.opcode == ppu_instructions::BLR())
-			{
-				start += 4;
-				continue;
-			}
-			else if (type == ppu_itype::B || type == ppu_itype::BC)
-			{
-				const u32 target = (op.aa ? 0 : addr) + (type == ppu_itype::B ? +op.bt24 : +op.bt14);
-
-				if (target == addr)
+					start += 4;
+					continue;
+				}
+				else if (type == ppu_itype::SC && op.opcode != ppu_instructions::SC(0))
 				{
 					break;
 				}
+				else if (addr == start && op.opcode == ppu_instructions::BLR())
+				{
+					start += 4;
+					continue;
+				}
+				else if (type == ppu_itype::B || type == ppu_itype::BC)
+				{
+					const u32 target = (op.aa ? 0 : addr) + (type == ppu_itype::B ? +op.bt24 : +op.bt14);
 
-				_ptr.set(next);
-			}
-			else if (type == ppu_itype::BCLR || type == ppu_itype::BCCTR)
-			{
-				_ptr.set(next);
-			}
+					if (target == addr)
+					{
+						break;
+					}
 
-			if (_ptr.addr() >= next)
-			{
-				LOG_WARNING(PPU, "Function gap: [0x%x] 0x%x bytes at 0x%x", func.addr, next - start, start);
-				break;
+					_ptr.set(next);
+				}
+				else if (type == ppu_itype::BCLR || type == ppu_itype::BCCTR)
+				{
+					_ptr.set(next);
+				}
+
+				if (_ptr.addr() >= next)
+				{
+					LOG_WARNING(PPU, "Function gap: [0x%x] 0x%x bytes at 0x%x", func.addr, next - start, start);
+					break;
+				}
 			}
 		}
-	}
+	});
+
+	const u64 gap_time = get_system_time() - gap_start;
 
 	// Fill TOCs for trivial case
 	if (TOCs.size() == 1)
@@ -1431,7 +1542,8 @@ void ppu_module::analyse(u32 lib_toc, u32 entry)
 		funcs.emplace_back(std::move(func));
 	}
 
-	LOG_NOTICE(PPU, "Function analysis: %zu functions (%zu enqueued)", funcs.size(), func_queue.size());
+	LOG_NOTICE(PPU, "Function analysis: %zu functions (%zu enqueued) in %.3fs (scans: %.3fs, gaps: %.3fs)", funcs.size(), func_queue.size(),
+		(get_system_time() - start_time) / 1000000., scan_time / 1000000., gap_time / 1000000.);
 }
 
 void ppu_acontext::UNK(ppu_opcode_t op)
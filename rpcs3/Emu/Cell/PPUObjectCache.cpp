@@ -0,0 +1,280 @@
+#include "stdafx.h"
+#include "PPUObjectCache.h"
+
+#include <zlib.h>
+
+// Archive header ("PPUOBJ01")
+static const u64 s_obj_magic = 0x31304a424f555050;
+
+struct obj_cache_header
+{
+	u64 magic;
+	u64 count;
+	u64 index_pos; // Index follows object data
+};
+
+struct obj_cache_index
+{
+	u64 pos;
+	u32 csize;
+	u32 usize;
+	u32 name_size; // Followed by name characters
+};
+
+ppu_obj_cache::ppu_obj_cache(const std::string& path)
+	: m_path(path)
+{
+	load();
+}
+
+void ppu_obj_cache::load()
+{
+	const std::string& path = m_path;
+
+	const fs::file file(path, fs::read);
+
+	if (!file || file.size() < sizeof(obj_cache_header))
+	{
+		return;
+	}
+
+	m_view = fs::file_view(file);
+
+	if (!m_view)
+	{
+		LOG_ERROR(PPU, "LLVM: Failed to map object cache: %s (%s)", path, fs::g_tls_error);
+		return;
+	}
+
+	const u8* const map = m_view.data();
+	const u64 size = m_view.size();
+
+	obj_cache_header header;
+	std::memcpy(&header, map, sizeof(header));
+
+	if (header.magic != s_obj_magic || header.index_pos < sizeof(header) || header.index_pos > size)
+	{
+		LOG_ERROR(PPU, "LLVM: Invalid object cache (will be rebuilt): %s", path);
+		return;
+	}
+
+	u64 pos = header.index_pos;
+
+	for (u64 i = 0; i < header.count; i++)
+	{
+		obj_cache_index index;
+
+		if (size - pos < sizeof(index))
+		{
+			break;
+		}
+
+		std::memcpy(&index, map + pos, sizeof(index));
+		pos += sizeof(index);
+
+		if (size - pos < index.name_size || index.pos < sizeof(header) || index.pos > header.index_pos || header.index_pos - index.pos < index.csize)
+		{
+			break;
+		}
+
+		std::string name(reinterpret_cast<const char*>(map + pos), index.name_size);
+		pos += index.name_size;
+
+		m_index[std::move(name)] = entry{index.pos, index.csize, index.usize, {}};
+	}
+
+	if (m_index.size() != header.count)
+	{
+		LOG_ERROR(PPU, "LLVM: Object cache index is truncated (%u/%u): %s", m_index.size(), header.count, path);
+		m_modified = true;
+	}
+}
+
+bool ppu_obj_cache::find(const std::string& name)
+{
+	reader_lock lock(m_mutex);
+
+	return m_index.count(name) != 0;
+}
+
+std::string ppu_obj_cache::get(const std::string& name)
+{
+	std::string result;
+
+	reader_lock lock(m_mutex);
+
+	const auto found = m_index.find(name);
+
+	if (found == m_index.end())
+	{
+		return result;
+	}
+
+	const entry& e = found->second;
+	const u8* src = e.pos ? m_view.data() + e.pos : reinterpret_cast<const u8*>(e.data.data());
+
+	result.resize(e.usize);
+
+	uLongf size = e.usize;
+
+	if (uncompress(reinterpret_cast<Bytef*>(&result.front()), &size, src, e.csize) != Z_OK || size != e.usize)
+	{
+		LOG_ERROR(PPU, "LLVM: Failed to decompress cached object: %s", name);
+		result.clear();
+	}
+
+	return result;
+}
+
+void ppu_obj_cache::add(const std::string& name, const void* data, std::size_t size)
+{
+	entry e{0, 0, ::narrow<u32>(size, HERE), {}};
+
+	// Compress without holding the lock
+	uLongf csize = compressBound(::narrow<uLong>(size, HERE));
+	e.data.resize(csize);
+
+	if (compress2(reinterpret_cast<Bytef*>(&e.data.front()), &csize, static_cast<const Bytef*>(data), ::narrow<uLong>(size, HERE), Z_DEFAULT_COMPRESSION) != Z_OK)
+	{
+		LOG_ERROR(PPU, "LLVM: Failed to compress object: %s", name);
+		return;
+	}
+
+	e.data.resize(csize);
+	e.csize = ::narrow<u32>(csize, HERE);
+
+	writer_lock lock(m_mutex);
+	m_index[name] = std::move(e);
+	m_modified = true;
+}
+
+bool ppu_obj_cache::import(const std::string& name, const std::string& path)
+{
+	fs::file legacy(path);
+
+	if (!legacy)
+	{
+		return false;
+	}
+
+	const std::string data = legacy.to_string();
+	legacy.close();
+
+	add(name, data.data(), data.size());
+	fs::remove_file(path);
+	LOG_NOTICE(PPU, "LLVM: Imported object file: %s", name);
+	return true;
+}
+
+void ppu_obj_cache::retain(const std::unordered_set<std::string>& live)
+{
+	writer_lock lock(m_mutex);
+
+	// Remove objects of old module versions, other tiers or settings, and old name formats
+	for (auto it = m_index.begin(); it != m_index.end();)
+	{
+		if (!live.count(it->first))
+		{
+			LOG_NOTICE(PPU, "LLVM: Removed stale object: %s", it->first);
+			it = m_index.erase(it);
+			m_modified = true;
+			continue;
+		}
+
+		it++;
+	}
+}
+
+bool ppu_obj_cache::save()
+{
+	writer_lock lock(m_mutex);
+
+	if (!m_modified)
+	{
+		return true;
+	}
+
+	// Write a new archive and replace the old one, so it's never left in inconsistent state
+	const std::string tmp_path = m_path + ".tmp";
+
+	fs::file out(tmp_path, fs::rewrite);
+
+	if (!out)
+	{
+		LOG_ERROR(PPU, "LLVM: Failed to write object cache: %s (%s)", tmp_path, fs::g_tls_error);
+		return false;
+	}
+
+	// Check every write: a truncated archive must never replace the old one
+	bool ok = true;
+
+	auto write = [&](const void* data, u64 size)
+	{
+		if (ok && out.write(data, size) != size)
+		{
+			ok = false;
+		}
+	};
+
+	obj_cache_header header{s_obj_magic, m_index.size(), 0};
+	write(&header, sizeof(header));
+
+	std::vector<std::pair<const std::string*, u64>> positions;
+	positions.reserve(m_index.size());
+
+	for (const auto& pair : m_index)
+	{
+		const entry& e = pair.second;
+		positions.emplace_back(&pair.first, out.pos());
+		write(e.pos ? m_view.data() + e.pos : reinterpret_cast<const u8*>(e.data.data()), e.csize);
+	}
+
+	header.index_pos = out.pos();
+
+	for (const auto& pos : positions)
+	{
+		const entry& e = m_index[*pos.first];
+
+		// Zero padding bytes
+		obj_cache_index index;
+		std::memset(&index, 0, sizeof(index));
+		index.pos = pos.second;
+		index.csize = e.csize;
+		index.usize = e.usize;
+		index.name_size = ::size32(*pos.first);
+		write(&index, sizeof(index));
+		write(pos.first->data(), pos.first->size());
+	}
+
+	const u64 total_size = out.pos();
+
+	out.seek(0);
+	write(&header, sizeof(header));
+	out.sync();
+
+	if (!ok || out.size() != total_size)
+	{
+		LOG_ERROR(PPU, "LLVM: Failed to write object cache: %s (%s)", tmp_path, fs::g_tls_error);
+		out.close();
+		fs::remove_file(tmp_path);
+		return false;
+	}
+
+	out.close();
+
+	m_view.close();
+
+	if (!fs::rename(tmp_path, m_path, true))
+	{
+		LOG_ERROR(PPU, "LLVM: Failed to replace object cache: %s (%s)", m_path, fs::g_tls_error);
+		m_index.clear();
+		load();
+		return false;
+	}
+
+	// Reload the index (pending data has been written)
+	m_index.clear();
+	m_modified = false;
+	load();
+	return true;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Utilities/File.h"
+#include "Utilities/mutex.h"
+#include <unordered_map>
+#include <unordered_set>
+#include <string>
+
+// Indexed archive of zlib-compressed PPU LLVM objects (replaces loose .obj files)
+class ppu_obj_cache
+{
+	struct entry
+	{
+		u64 pos; // Offset in mapped file (0 if pending)
+		u32 csize; // Compressed size
+		u32 usize; // Uncompressed size
+		std::string data; // Compressed data (pending entries only)
+	};
+
+	std::string m_path;
+
+	// Read-only view of the archive file
+	fs::file_view m_view;
+
+	shared_mutex m_mutex;
+
+	// Object name -> entry
+	std::unordered_map<std::string, entry> m_index;
+
+	bool m_modified = false;
+
+	void load();
+
+public:
+	// Open the archive at specified location (missing or broken archive is treated as empty)
+	explicit ppu_obj_cache(const std::string& path);
+
+	ppu_obj_cache(const ppu_obj_cache&) = delete;
+
+	// Check whether the object exists
+	bool find(const std::string& name);
+
+	// Get decompressed object (empty string if not found or corrupted)
+	std::string get(const std::string& name);
+
+	// Compress and add object, replacing existing one
+	void add(const std::string& name, const void* data, std::size_t size);
+
+	// Import loose object file if it exists (removes the file)
+	bool import(const std::string& name, const std::string& path);
+
+	// Remove all objects except specified ones (names of all parts of the module, compiled or not)
+	void retain(const std::unordered_set<std::string>& live);
+
+	// Rewrite the archive if it was modified
+	bool save();
+};
@@ -6,10 +6,12 @@
 #include "Emu/Memory/Memory.h"
 #include "Emu/System.h"
 #include "Emu/IdManager.h"
+#include "Emu/Benchmark.h"
 #include "PPUThread.h"
 #include "PPUInterpreter.h"
 #include "PPUAnalyser.h"
 #include "PPUModule.h"
+#include "PPUObjectCache.h"
 #include "SPURecompiler.h"
 #include "lv2/sys_sync.h"
 #include "lv2/sys_prx.h"
@@ -51,6 +53,9 @@
 #endif
 
 #include <thread>
+#include <deque>
+#include <set>
+#include <unordered_set>
 #include <cfenv>
 #include "Utilities/GSL.h"
 
@@ -111,6 +116,22 @@ void fmt_class_string<ppu_decoder_type>::format(std::string& out, u64 arg)
 	});
 }
 
+template <>
+void fmt_class_string<llvm_opt_level>::format(std::string& out, u64 arg)
+{
+	format_enum(out, arg, [](llvm_opt_level level)
+	{
+		switch (level)
+		{
+		case llvm_opt_level::fast: return "Fast";
+		case llvm_opt_level::balanced: return "Balanced";
+		case llvm_opt_level::aggressive: return "Aggressive";
+		}
+
+		return unknown;
+	});
+}
+
 // Table of identical interpreter functions when precise contains SSE2 version, and fast contains SSSE3 functions
 const std::pair<ppu_inter_func_t, ppu_inter_func_t> s_ppu_dispatch_table[]
 {
@@ -165,7 +186,7 @@ extern const ppu_decoder<ppu_interpreter_fast> g_ppu_interpreter_fast([](auto& t
 
 extern void ppu_initialize();
 extern void ppu_initialize(const ppu_module& info);
-static void ppu_initialize2(class jit_compiler& jit, const ppu_module& module_part, const std::string& cache_path, const std::string& obj_name);
+static std::string ppu_initialize2(class jit_compiler& jit, const ppu_module& module_part, const std::string& cache_path, const std::string& obj_name, const std::unordered_set<u64>& entries);
 extern void ppu_execute_syscall(ppu_thread& ppu, u64 code);
 
 // Get pointer to executable cache
@@ -336,6 +357,8 @@ extern void ppu_breakpoint(u32 addr, bool isAdding)
 
 void ppu_thread::on_spawn()
 {
+	thread_ctrl::set_class(thread_class::ppu);
+
 	if (g_cfg.core.thread_scheduler_enabled)
 	{
 		// Bind to primary set
@@ -900,21 +923,6 @@ const ppu_decoder<ppu_itype> s_ppu_itype;
 extern u64 get_timebased_time();
 extern ppu_function_t ppu_get_syscall(u64 code);
 
-extern __m128 sse_exp2_ps(__m128 A);
-extern __m128 sse_log2_ps(__m128 A);
-extern __m128i sse_altivec_vperm(__m128i A, __m128i B, __m128i C);
-extern __m128i sse_altivec_vperm_v0(__m128i A, __m128i B, __m128i C);
-extern __m128i sse_altivec_lvsl(u64 addr);
-extern __m128i sse_altivec_lvsr(u64 addr);
-extern __m128i sse_cellbe_lvlx(u64 addr);
-extern __m128i sse_cellbe_lvrx(u64 addr);
-extern void sse_cellbe_stvlx(u64 addr, __m128i a);
-extern void sse_cellbe_stvrx(u64 addr, __m128i a);
-extern __m128i sse_cellbe_lvlx_v0(u64 addr);
-extern __m128i sse_cellbe_lvrx_v0(u64 addr);
-extern void sse_cellbe_stvlx_v0(u64 addr, __m128i a);
-extern void sse_cellbe_stvrx_v0(u64 addr, __m128i a);
-
 [[noreturn]] static void ppu_trap(ppu_thread& ppu, u64 addr)
 {
 	ppu.cia = ::narrow<u32>(addr);
@@ -1074,6 +1082,7 @@ extern bool ppu_stwcx(ppu_thread& ppu, u32 addr, u32 reg_value)
 	{
 		if (ppu_stwcx_tx(addr, ppu.rtime, ppu.rdata, reg_value))
 		{
+			vm::reservation_wake(addr);
 			vm::reservation_notifier(addr, sizeof(u32)).notify_all();
 			ppu.raddr = 0;
 			return true;
@@ -1166,6 +1175,7 @@ extern bool ppu_stdcx(ppu_thread& ppu, u32 addr, u64 reg_value)
 	{
 		if (ppu_stdcx_tx(addr, ppu.rtime, ppu.rdata, reg_value))
 		{
+			vm::reservation_wake(addr);
 			vm::reservation_notifier(addr, sizeof(u64)).notify_all();
 			ppu.raddr = 0;
 			return true;
@@ -1250,6 +1260,265 @@ extern void ppu_initialize()
 	}
 }
 
+#ifdef LLVM_AVAILABLE
+// Compiler mutex (global)
+static semaphore<> s_ppu_jmutex;
+
+// Module part waiting for compilation (lazy mode)
+struct ppu_lazy_part
+{
+	ppu_module part;
+	std::string obj_name;
+	std::string cache_path;
+	std::shared_ptr<jit_compiler> jit;
+	std::shared_ptr<ppu_obj_cache> obj_cache;
+	std::vector<std::pair<std::string, u64>> globals;
+	std::vector<u32> entries; // Function entry points
+	std::unordered_set<u64> direct; // Functions which may be called directly (position-independent)
+	atomic_t<bool> queued{false};
+};
+
+// Lazy PPU compilation runtime: hot module parts are compiled in background
+class ppu_lazy_runtime final : public named_thread
+{
+	struct func_info
+	{
+		atomic_t<u32> count{0};
+		std::shared_ptr<ppu_lazy_part> part;
+	};
+
+	using func_map = std::unordered_map<u32, func_info*>;
+
+	shared_mutex m_mutex;
+
+	// Function entry point -> counter (immutable snapshot, replaced by add() so count() doesn't need the lock)
+	atomic_t<const func_map*> m_funcs{nullptr};
+
+	// All snapshots and counters (kept until the runtime is destroyed)
+	std::vector<std::unique_ptr<const func_map>> m_maps;
+	std::deque<func_info> m_infos;
+
+	// Parts waiting for compilation
+	std::deque<std::shared_ptr<ppu_lazy_part>> m_queue;
+
+	bool m_stop = false;
+
+	std::string get_name() const override
+	{
+		return "PPU Lazy Compiler";
+	}
+
+	void on_task() override;
+
+public:
+	void on_stop() override
+	{
+		{
+			writer_lock lock(m_mutex);
+			m_stop = true;
+		}
+
+		notify();
+		named_thread::on_stop();
+	}
+
+	// Register parts of the module (their blocks start running in the interpreter)
+	void add(const std::vector<std::shared_ptr<ppu_lazy_part>>& parts);
+
+	// Count function entry (lock-free unless the part is queued)
+	void count(u32 addr);
+};
+
+static ppu_lazy_runtime* s_ppu_lazy;
+
+// Interpreter entry for the blocks which are not compiled yet
+static bool ppu_lazy_entry(ppu_thread& ppu)
+{
+	const auto& table = g_ppu_interpreter_fast.get_table();
+	const u32 lazy = ::narrow<u32>(reinterpret_cast<std::uintptr_t>(&ppu_lazy_entry));
+	const u32 fallback = ::narrow<u32>(reinterpret_cast<std::uintptr_t>(&ppu_fallback));
+
+	s_ppu_lazy->count(ppu.cia);
+
+	while (true)
+	{
+		const u32 op = vm::read32(ppu.cia);
+
+		if (table[ppu_decode(op)](ppu, {op}))
+		{
+			ppu.cia += 4;
+		}
+
+		if (UNLIKELY(test(ppu.state)) && ppu.check_state())
+		{
+			return false;
+		}
+
+		const u32 next = ppu_ref(ppu.cia);
+
+		if (next == lazy)
+		{
+			// Continue interpreting from the next block
+			s_ppu_lazy->count(ppu.cia);
+			continue;
+		}
+
+		if (next != fallback)
+		{
+			// Return to the compiled code
+			return false;
+		}
+	}
+}
+
+void ppu_lazy_runtime::add(const std::vector<std::shared_ptr<ppu_lazy_part>>& parts)
+{
+	writer_lock lock(m_mutex);
+
+	const auto old = m_funcs.load();
+	auto funcs = old ? std::make_unique<func_map>(*old) : std::make_unique<func_map>();
+
+	for (const auto& part : parts)
+	{
+		for (u32 addr : part->entries)
+		{
+			m_infos.emplace_back();
+			m_infos.back().part = part;
+			(*funcs)[addr] = &m_infos.back();
+		}
+	}
+
+	// Publish the new snapshot before the entries become reachable
+	m_funcs = funcs.get();
+	m_maps.emplace_back(std::move(funcs));
+
+	for (const auto& part : parts)
+	{
+		for (const auto& func : part->part.funcs)
+		{
+			if (func.size)
+			{
+				ppu_ref(func.addr) = ::narrow<u32>(reinterpret_cast<std::uintptr_t>(&ppu_lazy_entry));
+			}
+		}
+	}
+}
+
+void ppu_lazy_runtime::count(u32 addr)
+{
+	const auto funcs = m_funcs.load();
+
+	if (!funcs)
+	{
+		return;
+	}
+
+	const auto found = funcs->find(addr);
+
+	if (found == funcs->end())
+	{
+		return;
+	}
+
+	func_info& info = *found->second;
+
+	// Stop counting when the part is already queued
+	if (info.part->queued || ++info.count < static_cast<u32>(g_cfg.core.ppu_lazy_threshold.get()) || info.part->queued.exchange(true))
+	{
+		return;
+	}
+
+	{
+		writer_lock lock(m_mutex);
+		m_queue.emplace_back(info.part);
+	}
+
+	notify();
+}
+
+void ppu_lazy_runtime::on_task()
+{
+	// Set low priority
+	thread_ctrl::set_native_priority(-1);
+
+	// Modified object caches
+	std::set<std::shared_ptr<ppu_obj_cache>> caches;
+
+	while (!Emu.IsStopped())
+	{
+		std::shared_ptr<ppu_lazy_part> part;
+
+		{
+			writer_lock lock(m_mutex);
+
+			if (m_stop)
+			{
+				break;
+			}
+
+			if (!m_queue.empty())
+			{
+				part = std::move(m_queue.front());
+				m_queue.pop_front();
+			}
+		}
+
+		if (!part)
+		{
+			thread_ctrl::wait();
+			continue;
+		}
+
+		// Use another JIT instance
+		jit_compiler jit2({}, g_cfg.core.llvm_cpu);
+		const std::string obj = ppu_initialize2(jit2, part->part, part->cache_path, part->obj_name, part->direct);
+
+		if (obj.empty())
+		{
+			continue;
+		}
+
+		part->obj_cache->add(part->obj_name, obj.data(), obj.size());
+		caches.emplace(part->obj_cache);
+
+		semaphore_lock lock(s_ppu_jmutex);
+		part->jit->add(obj.data(), obj.size());
+		part->jit->fin();
+
+		// Initialize global variables before the code becomes reachable
+		for (const auto& var : part->globals)
+		{
+			if (const u64 addr = part->jit->get(var.first))
+			{
+				*reinterpret_cast<u64*>(addr) = var.second;
+			}
+		}
+
+		// Replace interpreter entries
+		for (const auto& func : part->part.funcs)
+		{
+			if (!func.size)
+			{
+				continue;
+			}
+
+			if (const u64 addr = part->jit->get(func.name))
+			{
+				ppu_ref(func.addr) = ::narrow<u32>(addr);
+			}
+		}
+
+		LOG_SUCCESS(PPU, "LLVM: Compiled hot module %s", part->obj_name);
+	}
+
+	// Write compiled objects
+	for (const auto& cache : caches)
+	{
+		cache->save();
+	}
+}
+#endif
+
 extern void ppu_initialize(const ppu_module& info)
 {
 	if (g_cfg.core.ppu_decoder != ppu_decoder_type::llvm)
@@ -1291,15 +1560,6 @@ extern void ppu_initialize(const ppu_module& info)
 			{ "__ldarx", (u64)&ppu_ldarx },
 			{ "__stwcx", (u64)&ppu_stwcx },
 			{ "__stdcx", (u64)&ppu_stdcx },
-			{ "__vexptefp", (u64)&sse_exp2_ps },
-			{ "__vlogefp", (u64)&sse_log2_ps },
-			{ "__vperm", s_use_ssse3 ? (u64)&sse_altivec_vperm : (u64)&sse_altivec_vperm_v0 },
-			{ "__lvsl", (u64)&sse_altivec_lvsl },
-			{ "__lvsr", (u64)&sse_altivec_lvsr },
-			{ "__lvlx", s_use_ssse3 ? (u64)&sse_cellbe_lvlx : (u64)&sse_cellbe_lvlx_v0 },
-			{ "__lvrx", s_use_ssse3 ? (u64)&sse_cellbe_lvrx : (u64)&sse_cellbe_lvrx_v0 },
-			{ "__stvlx", s_use_ssse3 ? (u64)&sse_cellbe_stvlx : (u64)&sse_cellbe_stvlx_v0 },
-			{ "__stvrx", s_use_ssse3 ? (u64)&sse_cellbe_stvrx : (u64)&sse_cellbe_stvrx_v0 },
 		};
 
 		for (u64 index = 0; index < 1024; index++)
@@ -1364,9 +1624,6 @@ extern void ppu_initialize(const ppu_module& info)
 	// Compiler instance (deferred initialization)
 	std::shared_ptr<jit_compiler> jit;
 
-	// Compiler mutex (global)
-	static semaphore<> jmutex;
-
 	// Initialize global semaphore with the max number of threads
 	u32 max_threads = static_cast<u32>(g_cfg.core.llvm_threads);
 	s32 thread_count = max_threads > 0 ? std::min(max_threads, std::thread::hardware_concurrency()) : std::thread::hardware_concurrency();
@@ -1375,6 +1632,18 @@ extern void ppu_initialize(const ppu_module& info)
 	// Worker threads
 	std::vector<std::thread> jthreads;
 
+	// Compressed object archive for this location
+	const auto obj_cache = std::make_shared<ppu_obj_cache>(cache_path + "ppu-llvm-v2.dat");
+
+	// Remove stale objects only if all module parts are going to be checked
+	const bool obj_gc = jit_mod.vars.empty();
+
+	// Names of all parts of the module (including ones deferred to the lazy tier)
+	std::unordered_set<std::string> obj_live;
+
+	// Module parts compiled on demand (lazy mode)
+	std::vector<std::shared_ptr<ppu_lazy_part>> lazy_parts;
+
 	// Global variables to initialize
 	std::vector<std::pair<std::string, u64>> globals;
 
@@ -1384,6 +1653,23 @@ extern void ppu_initialize(const ppu_module& info)
 	// Difference between function name and current location
 	const u32 reloc = info.name.empty() ? 0 : info.segs.at(0).addr;
 
+	// Functions of the module which may be called directly (all parts are linked together, unless in lazy mode)
+	std::unordered_set<u64> entries;
+
+	if (!g_cfg.core.ppu_lazy)
+	{
+		for (const auto& func : info.funcs)
+		{
+			for (const auto& block : func.blocks)
+			{
+				if (block.second)
+				{
+					entries.emplace(block.first - reloc);
+				}
+			}
+		}
+	}
+
 	while (jit_mod.vars.empty() && fpos < info.funcs.size())
 	{
 		// Initialize compiler instance
@@ -1432,7 +1718,7 @@ extern void ppu_initialize(const ppu_module& info)
 		}
 
 		// Version, module name and hash: vX-liblv2.sprx-0123456789ABCDEF.obj
-		std::string obj_name = "v2";
+		std::string obj_name = "v4";
 
 		if (info.name.size())
 		{
@@ -1513,7 +1799,8 @@ extern void ppu_initialize(const ppu_module& info)
 			}
 
 			sha1_finish(&ctx, output);
-			fmt::append(obj_name, "-%016X-%s.obj", reinterpret_cast<be_t<u64>&>(output), jit_compiler::cpu(g_cfg.core.llvm_cpu));
+			// Objects built in lazy mode don't link other module parts directly
+			fmt::append(obj_name, "-%016X-%s%s-%s.obj", reinterpret_cast<be_t<u64>&>(output), fmt::to_lower(g_cfg.core.llvm_opt.to_string()), g_cfg.core.ppu_lazy ? "-lazy" : "", jit_compiler::cpu(g_cfg.core.llvm_cpu));
 		}
 
 		if (Emu.IsStopped())
@@ -1521,6 +1808,8 @@ extern void ppu_initialize(const ppu_module& info)
 			break;
 		}
 
+		obj_live.emplace(obj_name);
+
 		globals.emplace_back(fmt::format("__mptr%x", suffix), (u64)vm::g_base_addr);
 		globals.emplace_back(fmt::format("__cptr%x", suffix), (u64)vm::g_exec_addr);
 
@@ -1530,8 +1819,8 @@ extern void ppu_initialize(const ppu_module& info)
 			globals.emplace_back(fmt::format("__seg%u_%x", i, suffix), info.segs[i].addr);
 		}
 
-		// Check object file
-		if (fs::is_file(cache_path + obj_name))
+		// Check object archive (import old object file if present)
+		if (obj_cache->find(obj_name) || obj_cache->import(obj_name, cache_path + obj_name))
 		{
 			if (!jit)
 			{
@@ -1539,10 +1828,52 @@ extern void ppu_initialize(const ppu_module& info)
 				continue;
 			}
 
-			semaphore_lock lock(jmutex);
-			jit->add(cache_path + obj_name);
+			const std::string obj = obj_cache->get(obj_name);
+
+			if (!obj.empty())
+			{
+				g_jit_counters.ppu_cached++;
+
+				semaphore_lock lock(s_ppu_jmutex);
+				jit->add(obj.data(), obj.size());
+
+				LOG_SUCCESS(PPU, "LLVM: Loaded module %s", obj_name);
+				continue;
+			}
+		}
+
+		// Functions which may be called directly in lazy mode (other parts may be not compiled yet)
+		std::unordered_set<u64> part_entries;
+
+		if (g_cfg.core.ppu_lazy)
+		{
+			for (const auto& func : part.funcs)
+			{
+				if (func.size)
+				{
+					part_entries.emplace(func.addr - reloc);
+				}
+			}
+		}
+
+		if (jit && g_cfg.core.ppu_lazy)
+		{
+			// Defer compilation until the part becomes hot
+			auto lazy = std::make_shared<ppu_lazy_part>();
+			lazy->obj_name = obj_name;
+			lazy->cache_path = cache_path;
+			lazy->jit = jit;
+			lazy->obj_cache = obj_cache;
+			lazy->globals.assign(globals.end() - (2 + info.segs.size()), globals.end());
+
+			for (std::size_t i = fstart; i < fpos; i++)
+			{
+				lazy->entries.push_back(info.funcs[i].addr);
+			}
 
-			LOG_SUCCESS(PPU, "LLVM: Loaded module %s", obj_name);
+			lazy->direct = std::move(part_entries);
+			lazy->part = std::move(part);
+			lazy_parts.emplace_back(std::move(lazy));
 			continue;
 		}
 
@@ -1550,11 +1881,14 @@ extern void ppu_initialize(const ppu_module& info)
 		g_progr_ptotal++;
 
 		// Create worker thread for compilation
-		jthreads.emplace_back([&jit, obj_name = obj_name, part = std::move(part), &cache_path, jcores]()
+		jthreads.emplace_back([&jit, obj_name = obj_name, part = std::move(part), part_entries = std::move(part_entries), &entries, &cache_path, obj_cache, jcores]()
 		{
 			// Set low priority
 			thread_ctrl::set_native_priority(-1);
 
+			// Compiled object
+			std::string obj;
+
 			// Allocate "core"
 			{
 				semaphore_lock jlock(jcores->sem);
@@ -1563,20 +1897,27 @@ extern void ppu_initialize(const ppu_module& info)
 				{
 					// Use another JIT instance
 					jit_compiler jit2({}, g_cfg.core.llvm_cpu);
-					ppu_initialize2(jit2, part, cache_path, obj_name);
+					obj = ppu_initialize2(jit2, part, cache_path, obj_name, g_cfg.core.ppu_lazy ? part_entries : entries);
 				}
 
 				g_progr_pdone++;
 			}
 
-			if (Emu.IsStopped() || !jit || !fs::is_file(cache_path + obj_name))
+			if (obj.empty())
+			{
+				return;
+			}
+
+			obj_cache->add(obj_name, obj.data(), obj.size());
+
+			if (Emu.IsStopped() || !jit)
 			{
 				return;
 			}
 
 			// Proceed with original JIT instance
-			semaphore_lock lock(jmutex);
-			jit->add(cache_path + obj_name);
+			semaphore_lock lock(s_ppu_jmutex);
+			jit->add(obj.data(), obj.size());
 		});
 	}
 
@@ -1586,6 +1927,14 @@ extern void ppu_initialize(const ppu_module& info)
 		thread.join();
 	}
 
+	// Remove objects which don't match any part of the module anymore (parts compiled before the stop aren't lost)
+	if (!Emu.IsStopped() && obj_gc)
+	{
+		obj_cache->retain(obj_live);
+	}
+
+	obj_cache->save();
+
 	if (Emu.IsStopped() || !get_current_cpu_thread())
 	{
 		return;
@@ -1594,7 +1943,7 @@ extern void ppu_initialize(const ppu_module& info)
 	// Jit can be null if the loop doesn't ever enter.
 	if (jit && jit_mod.vars.empty())
 	{
-		semaphore_lock lock(jmutex);
+		semaphore_lock lock(s_ppu_jmutex);
 		jit->fin();
 
 		// Get and install function addresses
@@ -1608,7 +1957,11 @@ extern void ppu_initialize(const ppu_module& info)
 				{
 					const u64 addr = jit->get(fmt::format("__0x%x", block.first - reloc));
 					jit_mod.funcs.emplace_back(reinterpret_cast<ppu_function_t>(addr));
-					ppu_ref(block.first) = ::narrow<u32>(addr);
+
+					if (addr)
+					{
+						ppu_ref(block.first) = ::narrow<u32>(addr);
+					}
 				}
 			}
 		}
@@ -1625,6 +1978,19 @@ extern void ppu_initialize(const ppu_module& info)
 				*reinterpret_cast<u64*>(addr) = var.second;
 			}
 		}
+
+		if (!lazy_parts.empty())
+		{
+			// Incomplete module cannot be reused
+			jit_mod.funcs.clear();
+			jit_mod.vars.clear();
+
+			s_ppu_lazy = fxm::get_always<ppu_lazy_runtime>().get();
+
+			s_ppu_lazy->add(lazy_parts);
+
+			LOG_NOTICE(PPU, "LLVM: %u module parts will be compiled on demand", lazy_parts.size());
+		}
 	}
 	else
 	{
@@ -1663,11 +2029,17 @@ extern void ppu_initialize(const ppu_module& info)
 #endif
 }
 
-static void ppu_initialize2(jit_compiler& jit, const ppu_module& module_part, const std::string& cache_path, const std::string& obj_name)
+static std::string ppu_initialize2(jit_compiler& jit, const ppu_module& module_part, const std::string& cache_path, const std::string& obj_name, const std::unordered_set<u64>& entries)
 {
+	// Compiled object file
+	std::string result;
+
 #ifdef LLVM_AVAILABLE
 	using namespace llvm;
 
+	// Translation and compilation time
+	const u64 compile_start = get_system_time();
+
 	// Create LLVM module
 	std::unique_ptr<Module> module = std::make_unique<Module>(obj_name, jit.get_context());
 
@@ -1675,7 +2047,7 @@ static void ppu_initialize2(jit_compiler& jit, const ppu_module& module_part, co
 	module->setTargetTriple(Triple::normalize(sys::getProcessTriple()));
 
 	// Initialize translator
-	PPUTranslator translator(jit.get_context(), module.get(), module_part);
+	PPUTranslator translator(jit.get_context(), module.get(), module_part, entries, jit.has_ssse3(), jit.has_avx512bw());
 
 	// Define some types
 	const auto _void = Type::getVoidTy(jit.get_context());
@@ -1694,24 +2066,8 @@ static void ppu_initialize2(jit_compiler& jit, const ppu_module& module_part, co
 	{
 		legacy::FunctionPassManager pm(module.get());
 
-		// Basic optimizations
-		//pm.add(createCFGSimplificationPass());
-		//pm.add(createPromoteMemoryToRegisterPass());
-		pm.add(createEarlyCSEPass());
-		//pm.add(createTailCallEliminationPass());
-		//pm.add(createInstructionCombiningPass());
-		//pm.add(createBasicAAWrapperPass());
-		//pm.add(new MemoryDependenceAnalysis());
-		//pm.add(createLICMPass());
-		//pm.add(createLoopInstSimplifyPass());
-		//pm.add(createNewGVNPass());
-		pm.add(createDeadStoreEliminationPass());
-		//pm.add(createSCCPPass());
-		//pm.add(createReassociatePass());
-		//pm.add(createInstructionCombiningPass());
-		//pm.add(createInstructionSimplifierPass());
-		//pm.add(createAggressiveDCEPass());
-		//pm.add(createCFGSimplificationPass());
+		// Optimization passes for the selected tier (part of the object name)
+		llvm_add_opt_passes(pm, g_cfg.core.llvm_opt);
 		//pm.add(createLintPass()); // Check
 
 		// Translate functions
@@ -1720,7 +2076,7 @@ static void ppu_initialize2(jit_compiler& jit, const ppu_module& module_part, co
 			if (Emu.IsStopped())
 			{
 				LOG_SUCCESS(PPU, "LLVM: Translation cancelled");
-				return;
+				return result;
 			}
 
 			if (module_part.funcs[fi].size)
@@ -1734,7 +2090,7 @@ static void ppu_initialize2(jit_compiler& jit, const ppu_module& module_part, co
 				else
 				{
 					Emu.Pause();
-					return;
+					return result;
 				}
 			}
 		}
@@ -1747,28 +2103,37 @@ static void ppu_initialize2(jit_compiler& jit, const ppu_module& module_part, co
 		//mpm.add(createDeadInstEliminationPass());
 		//mpm.run(*module);
 
-		std::string result;
-		raw_string_ostream out(result);
+		std::string log;
+		raw_string_ostream out(log);
 
 		if (g_cfg.core.llvm_logs)
 		{
 			out << *module; // print IR
 			fs::file(cache_path + obj_name + ".log", fs::rewrite).write(out.str());
-			result.clear();
+			log.clear();
 		}
 
 		if (verifyModule(*module, &out))
 		{
 			out.flush();
-			LOG_ERROR(PPU, "LLVM: Verification failed for %s:\n%s", obj_name, result);
+			LOG_ERROR(PPU, "LLVM: Verification failed for %s:\n%s", obj_name, log);
 			Emu.CallAfter([]{ Emu.Stop(); });
-			return;
+			return result;
 		}
 
 		LOG_NOTICE(PPU, "LLVM: %zu functions generated", module->getFunctionList().size());
 	}
 
-	// Load or compile module
-	jit.add(std::move(module), cache_path);
+	// Compile module
+	jit.add(std::move(module), [&](const char* data, std::size_t size)
+	{
+		result.assign(data, size);
+		LOG_SUCCESS(PPU, "LLVM: Created module: %s", obj_name);
+	});
+
+	g_jit_counters.ppu_compiled++;
+	g_jit_counters.ppu_time += get_system_time() - compile_start;
 #endif // LLVM_AVAILABLE
+
+	return result;
 }
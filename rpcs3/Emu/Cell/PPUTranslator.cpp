@@ -11,9 +11,12 @@ using namespace llvm;
 
 const ppu_decoder<PPUTranslator> s_ppu_decoder;
 
-PPUTranslator::PPUTranslator(LLVMContext& context, Module* module, const ppu_module& info)
+PPUTranslator::PPUTranslator(LLVMContext& context, Module* module, const ppu_module& info, const std::unordered_set<u64>& entries, bool ssse3, bool avx512bw)
 	: cpu_translator(module, false)
 	, m_info(info)
+	, m_entries(entries)
+	, m_ssse3(ssse3)
+	, m_avx512bw(avx512bw)
 	, m_pure_attr(AttributeList::get(m_context, AttributeList::FunctionIndex, {Attribute::NoUnwind, Attribute::ReadNone}))
 {
 	// Bind context
@@ -258,6 +261,8 @@ void PPUTranslator::CallFunction(u64 target, Value* indirect)
 	const auto type = FunctionType::get(GetType<void>(), {m_thread_type->getPointerTo()}, false);
 	const auto block = m_ir->GetInsertBlock();
 
+	Value* callee = nullptr;
+
 	if (!indirect)
 	{
 		if ((!m_reloc && target < 0x10000) || target >= -0x10000)
@@ -266,9 +271,36 @@ void PPUTranslator::CallFunction(u64 target, Value* indirect)
 			return;
 		}
 
-		indirect = m_module->getOrInsertFunction(fmt::format("__0x%llx", target), type);
+		if (m_entries.count(target))
+		{
+			// Direct call to the function compiled in the same module
+			static_assert(fmt::check_format<u64>("__0x%llx"), "");
+			char name[24];
+			const auto func = m_module->getOrInsertFunction({name, fmt::format_to(name, "__0x%llx", target)}, type);
+
+			// Only while the table still points to it (patches, breakpoints and re-registration replace the entry)
+			const auto pos = m_ir->CreateLShr(GetAddr(target - m_addr), 2, "", true);
+			const auto ptr = m_ir->CreateGEP(m_ir->CreateLoad(m_call), {m_ir->getInt64(0), pos});
+			const auto entry = m_ir->CreateLoad(ptr);
+			const auto direct = BasicBlock::Create(m_context, "__direct", m_function);
+			const auto table = BasicBlock::Create(m_context, "__table", m_function);
+			m_ir->CreateCondBr(m_ir->CreateICmpEQ(entry, m_ir->CreatePtrToInt(func, entry->getType())), direct, table, m_md_likely);
+			m_ir->SetInsertPoint(direct);
+			m_ir->CreateCall(func, {m_thread})->setTailCallKind(llvm::CallInst::TCK_Tail);
+			m_ir->CreateRetVoid();
+			m_ir->SetInsertPoint(table);
+			m_ir->CreateCall(m_ir->CreateIntToPtr(entry, type->getPointerTo()), {m_thread})->setTailCallKind(llvm::CallInst::TCK_Tail);
+			m_ir->CreateRetVoid();
+			return;
+		}
+		else
+		{
+			// Call through the table (the target may be in another module, not compiled yet or not a known function)
+			indirect = GetAddr(target - m_addr);
+		}
 	}
-	else
+
+	if (!callee)
 	{
 		// Try to optimize
 		if (auto inst = dyn_cast_or_null<Instruction>(indirect))
@@ -281,11 +313,11 @@ void PPUTranslator::CallFunction(u64 target, Value* indirect)
 
 		const auto pos = m_ir->CreateLShr(indirect, 2, "", true);
 		const auto ptr = m_ir->CreateGEP(m_ir->CreateLoad(m_call), {m_ir->getInt64(0), pos});
-		indirect = m_ir->CreateIntToPtr(m_ir->CreateLoad(ptr), type->getPointerTo());
+		callee = m_ir->CreateIntToPtr(m_ir->CreateLoad(ptr), type->getPointerTo());
 	}
 
 	m_ir->SetInsertPoint(block);
-	m_ir->CreateCall(indirect, {m_thread})->setTailCallKind(llvm::CallInst::TCK_Tail);
+	m_ir->CreateCall(callee, {m_thread})->setTailCallKind(llvm::CallInst::TCK_Tail);
 	m_ir->CreateRetVoid();
 }
 
@@ -481,6 +513,40 @@ Value* PPUTranslator::Shuffle(Value* left, Value* right, std::initializer_list<u
 	return m_ir->CreateShuffleVector(left, right, ConstantDataVector::get(m_context, { indices.begin(), indices.end() }));
 }
 
+Value* PPUTranslator::Pshufb(Value* data, Value* index)
+{
+	if (m_ssse3)
+	{
+		return Call(GetType<u8[16]>(), m_pure_attr, "llvm.x86.ssse3.pshuf.b.128", data, index);
+	}
+
+	const auto mask = m_ir->CreateAnd(index, 0xf);
+	const auto zero = ConstantVector::getSplat(16, m_ir->getInt8(0));
+
+	Value* result = zero;
+
+	for (u32 i = 0; i < 16; i++)
+	{
+		result = m_ir->CreateInsertElement(result, m_ir->CreateExtractElement(data, m_ir->CreateExtractElement(mask, i)), i);
+	}
+
+	return m_ir->CreateSelect(m_ir->CreateICmpSLT(index, zero), zero, result);
+}
+
+Value* PPUTranslator::GetUnalignedIndex(Value* addr, bool right)
+{
+	// Byte i (reversed order) is taken from byte 15 - i + (addr & 15) of the block, or (addr & 15) - 1 - i for the right part
+	std::vector<u8> base(16);
+
+	for (u32 i = 0; i < 16; i++)
+	{
+		base[i] = static_cast<u8>((right ? 0xff : 0xf) - i);
+	}
+
+	const auto sh = Broadcast(Trunc(m_ir->CreateAnd(addr, 0xf), GetType<u8>()), 16);
+	return m_ir->CreateAdd(ConstantDataVector::get(m_context, base), sh);
+}
+
 Value* PPUTranslator::SExt(Value* value, Type* type)
 {
 	return m_ir->CreateSExt(value, type ? type : ScaleType(value->getType(), 1));
@@ -522,7 +588,20 @@ void PPUTranslator::UseCondition(MDNode* hint, Value* cond)
 	}
 }
 
-llvm::Value* PPUTranslator::GetMemory(llvm::Value* addr, llvm::Type* type)
+llvm::void PPUTranslator::StoreMasked(Value* data, Value* addr, Value* mask)
+{
+	if (m_avx512bw)
+	{
+		// Native byte-masked store (vmovdqu8), LLVM scalarizes it on other targets
+		m_ir->CreateMaskedStore(data, GetMemory(addr, GetType<u8[16]>()), 16, mask);
+		return;
+	}
+
+	// maskmovdqu is a single byte-masked store, unlike load+blend+store it can't overwrite neighbouring bytes written by another thread
+	Call(GetType<void>(), "llvm.x86.sse2.maskmov.dqu", data, SExt(mask, GetType<u8[16]>()), GetMemory(addr, GetType<u8>()));
+}
+
+Value* PPUTranslator::GetMemory(llvm::Value* addr, llvm::Type* type)
 {
 	return m_ir->CreateBitCast(m_ir->CreateGEP(m_base_loaded, {m_ir->getInt64(0), addr}), type->getPointerTo());
 }
@@ -884,12 +963,37 @@ void PPUTranslator::VCTUXS(ppu_opcode_t op)
 
 void PPUTranslator::VEXPTEFP(ppu_opcode_t op)
 {
-	SetVr(op.vd, Call(GetType<f32[4]>(), m_pure_attr, "__vexptefp", GetVr(op.vb, VrType::vf)));
+	// Rational approximation of 2^x (same as in the interpreter)
+	const auto type = GetType<f32[4]>();
+	const auto fc = [&](f32 value) { return Broadcast(ConstantFP::get(GetType<f32>(), value), 4); };
+	const auto x0 = Call(type, m_pure_attr, "llvm.x86.sse.max.ps", Call(type, m_pure_attr, "llvm.x86.sse.min.ps", GetVr(op.vb, VrType::vf), fc(127.4999961f)), fc(-127.4999961f));
+	const auto x1 = m_ir->CreateFAdd(x0, fc(0.5f));
+	const auto x2 = m_ir->CreateSub(Call(GetType<u32[4]>(), m_pure_attr, "llvm.x86.sse2.cvtps2dq", x1), ZExt(m_ir->CreateFCmpUGE(fc(0.f), x1), GetType<u32[4]>()));
+	const auto x3 = m_ir->CreateFSub(x0, m_ir->CreateSIToFP(x2, type));
+	const auto x4 = m_ir->CreateFMul(x3, x3);
+	const auto x5 = m_ir->CreateFMul(x3, m_ir->CreateFAdd(m_ir->CreateFMul(m_ir->CreateFAdd(m_ir->CreateFMul(x4, fc(0.023093347705f)), fc(20.20206567f)), x4), fc(1513.906801f)));
+	const auto x6 = m_ir->CreateFMul(x5, Call(type, m_pure_attr, "llvm.x86.sse.rcp.ps", m_ir->CreateFSub(m_ir->CreateFAdd(m_ir->CreateFMul(fc(233.1842117f), x4), fc(4368.211667f)), x5)));
+	const auto x7 = m_ir->CreateBitCast(m_ir->CreateShl(m_ir->CreateAdd(x2, Broadcast(m_ir->getInt32(127), 4)), 23), type);
+	SetVr(op.vd, m_ir->CreateFMul(m_ir->CreateFAdd(m_ir->CreateFAdd(x6, x6), fc(1.0f)), x7));
 }
 
 void PPUTranslator::VLOGEFP(ppu_opcode_t op)
 {
-	SetVr(op.vd, Call(GetType<f32[4]>(), m_pure_attr, "__vlogefp", GetVr(op.vb, VrType::vf)));
+	// Rational approximation of log2(x) (same as in the interpreter)
+	const auto type = GetType<f32[4]>();
+	const auto fc = [&](f32 value) { return Broadcast(ConstantFP::get(GetType<f32>(), value), 4); };
+	const auto x0 = Call(type, m_pure_attr, "llvm.x86.sse.max.ps", GetVr(op.vb, VrType::vf), m_ir->CreateBitCast(Broadcast(m_ir->getInt32(0x00800000), 4), type));
+	const auto i0 = m_ir->CreateBitCast(x0, GetType<u32[4]>());
+	const auto x1 = m_ir->CreateBitCast(m_ir->CreateOr(m_ir->CreateAnd(i0, 0x807fffff), 0x3f800000), type);
+	const auto x2 = Call(type, m_pure_attr, "llvm.x86.sse.rcp.ps", m_ir->CreateFAdd(x1, fc(1.0f)));
+	const auto x3 = m_ir->CreateFMul(m_ir->CreateFSub(x1, fc(1.0f)), x2);
+	const auto x4 = m_ir->CreateFAdd(x3, x3);
+	const auto x5 = m_ir->CreateFMul(x4, x4);
+	const auto x6 = m_ir->CreateFAdd(m_ir->CreateFMul(m_ir->CreateFAdd(m_ir->CreateFMul(fc(-0.7895802789f), x5), fc(16.38666457f)), x5), fc(-64.1409953f));
+	const auto x7 = Call(type, m_pure_attr, "llvm.x86.sse.rcp.ps", m_ir->CreateFAdd(m_ir->CreateFMul(m_ir->CreateFAdd(m_ir->CreateFMul(fc(-35.67227983f), x5), fc(312.0937664f)), x5), fc(-769.6919436f)));
+	const auto x8 = m_ir->CreateSIToFP(m_ir->CreateSub(m_ir->CreateLShr(i0, 23), Broadcast(m_ir->getInt32(127), 4)), type);
+	const auto c = fc(1.442695040f);
+	SetVr(op.vd, m_ir->CreateFAdd(m_ir->CreateFMul(m_ir->CreateFMul(m_ir->CreateFMul(m_ir->CreateFMul(x5, x6), x7), x4), c), m_ir->CreateFAdd(m_ir->CreateFMul(x4, c), x8)));
 }
 
 void PPUTranslator::VMADDFP(ppu_opcode_t op)
@@ -1194,7 +1298,35 @@ void PPUTranslator::VOR(ppu_opcode_t op)
 void PPUTranslator::VPERM(ppu_opcode_t op)
 {
 	const auto abc = GetVrs(VrType::vi8, op.va, op.vb, op.vc);
-	SetVr(op.vd, Call(GetType<u8[16]>(), m_pure_attr, "__vperm", abc[0], abc[1], abc[2]));
+
+	// Reversed byte order: index 31 - c selects A for c < 16
+	const auto index = m_ir->CreateAnd(m_ir->CreateNot(abc[2]), 0x1f);
+
+	if (!m_ssse3)
+	{
+		// Concatenate B and A (32 bytes) and select by index directly
+		std::vector<u32> concat(32);
+
+		for (u32 i = 0; i < 32; i++)
+		{
+			concat[i] = i;
+		}
+
+		const auto ba = m_ir->CreateShuffleVector(abc[1], abc[0], ConstantDataVector::get(m_context, concat));
+
+		Value* result = GetUndef<u8[16]>();
+
+		for (u32 i = 0; i < 16; i++)
+		{
+			result = m_ir->CreateInsertElement(result, m_ir->CreateExtractElement(ba, m_ir->CreateExtractElement(index, i)), i);
+		}
+
+		SetVr(op.vd, result);
+		return;
+	}
+
+	const auto mask = m_ir->CreateICmpUGT(index, Broadcast(m_ir->getInt8(0xf), 16));
+	SetVr(op.vd, m_ir->CreateSelect(mask, Pshufb(abc[0], index), Pshufb(abc[1], index)));
 }
 
 void PPUTranslator::VPKPX(ppu_opcode_t op)
@@ -2257,10 +2389,7 @@ void PPUTranslator::TW(ppu_opcode_t op)
 void PPUTranslator::LVSL(ppu_opcode_t op)
 {
 	const auto addr = op.ra ? m_ir->CreateAdd(GetGpr(op.ra), GetGpr(op.rb)) : GetGpr(op.rb);
-	//const auto _add = m_ir->CreateInsertElement(ConstantVector::getSplat(16, m_ir->getInt8(0)), Trunc(m_ir->CreateAnd(addr, 0xf), GetType<u8>()), m_ir->getInt32(0));
-	//const auto base = ConstantDataVector::get(m_context, std::vector<u8>{15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0});
-	//SetVr(op.vd, m_ir->CreateAdd(base, Shuffle(_add, nullptr, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0})));
-	SetVr(op.vd, Call(GetType<u8[16]>(), m_pure_attr, "__lvsl", addr));
+	SetVr(op.vd, GetUnalignedIndex(addr, false));
 }
 
 void PPUTranslator::LVEBX(ppu_opcode_t op)
@@ -2415,10 +2544,8 @@ void PPUTranslator::CMPL(ppu_opcode_t op)
 void PPUTranslator::LVSR(ppu_opcode_t op)
 {
 	const auto addr = op.ra ? m_ir->CreateAdd(GetGpr(op.ra), GetGpr(op.rb)) : GetGpr(op.rb);
-	//const auto _add = m_ir->CreateInsertElement(ConstantVector::getSplat(16, m_ir->getInt8(0)), Trunc(m_ir->CreateAnd(addr, 0xf), GetType<u8>()), m_ir->getInt32(0));
-	//const auto base = ConstantDataVector::get(m_context, std::vector<u8>{31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16});
-	//SetVr(op.vd, m_ir->CreateSub(base, Shuffle(_add, nullptr, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0})));
-	SetVr(op.vd, Call(GetType<u8[16]>(), m_pure_attr, "__lvsr", addr));
+	const auto base = ConstantDataVector::get(m_context, std::vector<u8>{31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16});
+	SetVr(op.vd, m_ir->CreateSub(base, Broadcast(Trunc(m_ir->CreateAnd(addr, 0xf), GetType<u8>()), 16)));
 }
 
 void PPUTranslator::LVEHX(ppu_opcode_t op)
@@ -3023,7 +3150,9 @@ void PPUTranslator::DIVW(ppu_opcode_t op)
 void PPUTranslator::LVLX(ppu_opcode_t op)
 {
 	const auto addr = op.ra ? m_ir->CreateAdd(GetGpr(op.ra), GetGpr(op.rb)) : GetGpr(op.rb);
-	SetVr(op.vd, Call(GetType<u8[16]>(), "__lvlx", addr));
+	const auto index = GetUnalignedIndex(addr, false);
+	const auto data = ReadMemory(m_ir->CreateAnd(addr, ~0xfull), GetType<u8[16]>(), false, 16);
+	SetVr(op.vd, m_ir->CreateSelect(m_ir->CreateICmpULT(index, Broadcast(m_ir->getInt8(16), 16)), Pshufb(data, index), ConstantVector::getSplat(16, m_ir->getInt8(0))));
 }
 
 void PPUTranslator::LDBRX(ppu_opcode_t op)
@@ -3068,7 +3197,9 @@ void PPUTranslator::SRD(ppu_opcode_t op)
 void PPUTranslator::LVRX(ppu_opcode_t op)
 {
 	const auto addr = op.ra ? m_ir->CreateAdd(GetGpr(op.ra), GetGpr(op.rb)) : GetGpr(op.rb);
-	SetVr(op.vd, Call(GetType<u8[16]>(), "__lvrx", addr));
+	const auto index = GetUnalignedIndex(addr, true);
+	const auto data = ReadMemory(m_ir->CreateAnd(addr, ~0xfull), GetType<u8[16]>(), false, 16);
+	SetVr(op.vd, m_ir->CreateSelect(m_ir->CreateICmpULT(index, Broadcast(m_ir->getInt8(16), 16)), Pshufb(data, index), ConstantVector::getSplat(16, m_ir->getInt8(0))));
 }
 
 void PPUTranslator::LSWI(ppu_opcode_t op)
@@ -3138,7 +3269,10 @@ void PPUTranslator::LFDUX(ppu_opcode_t op)
 
 void PPUTranslator::STVLX(ppu_opcode_t op)
 {
-	Call(GetType<void>(), "__stvlx", op.ra ? m_ir->CreateAdd(GetGpr(op.ra), GetGpr(op.rb)) : GetGpr(op.rb), GetVr(op.vs, VrType::vi8));
+	const auto addr = op.ra ? m_ir->CreateAdd(GetGpr(op.ra), GetGpr(op.rb)) : GetGpr(op.rb);
+	const auto index = GetUnalignedIndex(addr, false);
+	const auto mask = m_ir->CreateICmpULT(index, Broadcast(m_ir->getInt8(16), 16));
+	StoreMasked(Pshufb(GetVr(op.vs, VrType::vi8), index), m_ir->CreateAnd(addr, ~0xfull), mask);
 }
 
 void PPUTranslator::STDBRX(ppu_opcode_t op)
@@ -3164,7 +3298,10 @@ void PPUTranslator::STFSX(ppu_opcode_t op)
 
 void PPUTranslator::STVRX(ppu_opcode_t op)
 {
-	Call(GetType<void>(), "__stvrx", op.ra ? m_ir->CreateAdd(GetGpr(op.ra), GetGpr(op.rb)) : GetGpr(op.rb), GetVr(op.vs, VrType::vi8));
+	const auto addr = op.ra ? m_ir->CreateAdd(GetGpr(op.ra), GetGpr(op.rb)) : GetGpr(op.rb);
+	const auto index = GetUnalignedIndex(addr, true);
+	const auto mask = m_ir->CreateICmpULT(index, Broadcast(m_ir->getInt8(16), 16));
+	StoreMasked(Pshufb(GetVr(op.vs, VrType::vi8), index), m_ir->CreateAnd(addr, ~0xfull), mask);
 }
 
 void PPUTranslator::STFSUX(ppu_opcode_t op)
@@ -14,6 +14,15 @@ class PPUTranslator final : public cpu_translator
 	// Relevant relocations
 	std::map<u64, const ppu_reloc*> m_relocs;
 
+	// Position-independent addresses of functions which may be called directly (linked in the same JIT instance)
+	const std::unordered_set<u64>& m_entries;
+
+	// Host supports SSSE3 (pshufb)
+	const bool m_ssse3;
+
+	// Host supports AVX-512BW (byte-masked stores)
+	const bool m_avx512bw;
+
 	// Attributes for function calls which are "pure" and may be optimized away if their results are unused
 	const llvm::AttributeList m_pure_attr;
 
@@ -187,6 +196,12 @@ public:
 	// Create shuffle instruction with constant args
 	llvm::Value* Shuffle(llvm::Value* left, llvm::Value* right, std::initializer_list<u32> indices);
 
+	// Select bytes by variable index like pshufb (zero if bit 7 of the index is set)
+	llvm::Value* Pshufb(llvm::Value* data, llvm::Value* index);
+
+	// Get byte indices of the aligned 16-byte block for LVLX/STVLX or LVRX/STVRX (index >= 16 if the byte is not accessed)
+	llvm::Value* GetUnalignedIndex(llvm::Value* addr, bool right);
+
 	// Create sign extension (with double size if type is nullptr)
 	llvm::Value* SExt(llvm::Value* value, llvm::Type* = nullptr);
 
@@ -288,6 +303,9 @@ public:
 	// Write to memory
 	void WriteMemory(llvm::Value* addr, llvm::Value* value, bool is_be = true, u32 align = 1);
 
+	// Write bytes of 16-byte vector to aligned address where mask is set
+	void StoreMasked(llvm::Value* data, llvm::Value* addr, llvm::Value* mask);
+
 	// Get an undefined value with specified type
 	template<typename T>
 	llvm::Value* GetUndef()
@@ -313,7 +331,7 @@ public:
 	// Handle compilation errors
 	void CompilationError(const std::string& error);
 
-	PPUTranslator(llvm::LLVMContext& context, llvm::Module* module, const ppu_module& info);
+	PPUTranslator(llvm::LLVMContext& context, llvm::Module* module, const ppu_module& info, const std::unordered_set<u64>& entries, bool ssse3, bool avx512bw);
 	~PPUTranslator();
 
 	// Get thread context struct type
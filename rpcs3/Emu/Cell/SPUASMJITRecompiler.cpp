@@ -2,6 +2,7 @@
 #include "Emu/Memory/Memory.h"
 #include "Emu/System.h"
 #include "Emu/IdManager.h"
+#include "Emu/Benchmark.h"
 
 #include "SPUDisAsm.h"
 #include "SPUThread.h"
@@ -60,6 +61,16 @@ void spu_recompiler::init()
 		m_cache = fxm::get<spu_cache>();
 		m_spurt = fxm::get_always<spu_runtime>();
 	}
+
+	if (!m_tier && spu_tier_runtime::enabled())
+	{
+		m_tier = fxm::get_always<spu_tier_runtime>();
+	}
+
+	if (!m_profiler && spu_profiler::enabled())
+	{
+		m_profiler = fxm::get_always<spu_profiler>();
+	}
 }
 
 spu_function_t spu_recompiler::get(u32 lsa)
@@ -89,9 +100,12 @@ spu_function_t spu_recompiler::compile(std::vector<u32>&& func_rv)
 
 	if (fn_location)
 	{
+		g_jit_counters.spu_cached++;
 		return fn_location;
 	}
 
+	const u64 compile_start = get_system_time();
+
 	auto& func = fn_info.first->first;
 
 	using namespace asmjit;
@@ -692,6 +706,65 @@ spu_function_t spu_recompiler::compile(std::vector<u32>&& func_rv)
 
 	c->inc(SPU_OFF_64(block_counter));
 
+	if (m_tier)
+	{
+		// Jump to the promoted function if available, otherwise count executions
+		const auto entry = m_tier->get(func);
+		Label label_base = c->newLabel();
+		Label label_hot = c->newLabel();
+		Label label_cont = c->newLabel();
+		c->mov(x86::rax, imm_ptr(entry));
+		c->mov(x86::r10, x86::qword_ptr(x86::rax, offset32(&spu_tier_entry::func)));
+		c->test(x86::r10, x86::r10);
+		c->jz(label_base);
+		c->jmp(x86::r10);
+		c->bind(label_base);
+		c->inc(x86::qword_ptr(x86::rax, offset32(&spu_tier_entry::count)));
+		c->cmp(x86::qword_ptr(x86::rax, offset32(&spu_tier_entry::count)), g_cfg.core.spu_tier_threshold.get());
+		c->jae(label_hot);
+		c->bind(label_cont);
+
+		after.emplace_back([=]
+		{
+			// Request recompilation once (lost increments may skip the exact threshold value) and return to the dispatcher
+			c->align(kAlignCode, 16);
+			c->bind(label_hot);
+			c->test(x86::dword_ptr(x86::rax, offset32(&spu_tier_entry::queued)), 1);
+			c->jnz(label_cont);
+			c->lock().bts(x86::dword_ptr(x86::rax, offset32(&spu_tier_entry::queued)), 0);
+			c->jc(label_cont);
+			c->jmp(imm_ptr(&spu_tier_runtime::promote));
+		});
+	}
+
+	if (m_profiler)
+	{
+		// Update block statistics (in tiered mode, promoted blocks are counted by LLVM)
+		const auto entry = m_profiler->get(func);
+		c->mov(x86::r10, imm_ptr(entry));
+		c->inc(x86::qword_ptr(x86::r10, offset32(&spu_profile_entry::count)));
+
+		if (g_cfg.core.spu_profiler_cycles)
+		{
+			// Add elapsed time to the previous block, rdx must be preserved (arg on Windows)
+			Label label_first = c->newLabel();
+			c->mov(x86::r11, x86::rdx);
+			c->rdtsc();
+			c->shl(x86::rdx, 32);
+			c->or_(x86::rax, x86::rdx);
+			c->mov(x86::rdx, SPU_OFF_64(profile_last));
+			c->mov(SPU_OFF_64(profile_last), x86::r10);
+			c->test(x86::rdx, x86::rdx);
+			c->jz(label_first);
+			c->mov(x86::r10, x86::rax);
+			c->sub(x86::r10, SPU_OFF_64(profile_tsc));
+			c->add(x86::qword_ptr(x86::rdx, offset32(&spu_profile_entry::cycles)), x86::r10);
+			c->bind(label_first);
+			c->mov(SPU_OFF_64(profile_tsc), x86::rax);
+			c->mov(x86::rdx, x86::r11);
+		}
+	}
+
 	for (u32 i = 1; i < func.size(); i++)
 	{
 		const u32 pos = start + (i - 1) * 4;
@@ -1060,6 +1133,8 @@ spu_function_t spu_recompiler::compile(std::vector<u32>&& func_rv)
 		m_cache->add(func);
 	}
 
+	g_jit_counters.spu_compiled++;
+	g_jit_counters.spu_time += get_system_time() - compile_start;
 	return fn;
 }
 
@@ -1162,7 +1237,8 @@ void spu_recompiler::branch_fixed(u32 target)
 		return;
 	}
 
-	c->mov(x86::rax, x86::qword_ptr(*cpu, offset32(&SPUThread::jit_dispatcher) + target * 2));
+	c->mov(x86::rax, SPU_OFF_64(jit_dispatcher));
+	c->mov(x86::rax, x86::qword_ptr(x86::rax, target * 2));
 	c->mov(SPU_OFF_32(pc), target);
 	c->cmp(SPU_OFF_32(state), 0);
 	c->jnz(label_stop);
@@ -1198,7 +1274,8 @@ void spu_recompiler::branch_indirect(spu_opcode_t op, bool jt, bool ret)
 	if (g_cfg.core.spu_block_size != spu_block_size_type::giga && !jt)
 	{
 		// Simply external call (return or indirect call)
-		c->mov(x86::r10, x86::qword_ptr(*cpu, addr->r64(), 1, offset32(&SPUThread::jit_dispatcher)));
+		c->mov(x86::r10, SPU_OFF_64(jit_dispatcher));
+		c->mov(x86::r10, x86::qword_ptr(x86::r10, addr->r64(), 1, 0));
 		c->xor_(qw0->r32(), qw0->r32());
 	}
 	else
@@ -1219,7 +1296,8 @@ void spu_recompiler::branch_indirect(spu_opcode_t op, bool jt, bool ret)
 		c->cmp(qw1->r32(), end - start);
 		c->cmovae(qw1->r32(), qw0->r32());
 		c->cmovb(x86::r10, x86::qword_ptr(x86::r10, *qw1, 1, 0));
-		c->cmovae(x86::r10, x86::qword_ptr(*cpu, addr->r64(), 1, offset32(&SPUThread::jit_dispatcher)));
+		c->mov(*qw1, SPU_OFF_64(jit_dispatcher));
+		c->cmovae(x86::r10, x86::qword_ptr(*qw1, addr->r64(), 1, 0));
 	}
 
 	if (op.d)
@@ -1248,7 +1326,8 @@ void spu_recompiler::branch_indirect(spu_opcode_t op, bool jt, bool ret)
 		c->lock().btr(SPU_OFF_8(interrupts_enabled), 0);
 		c->mov(SPU_OFF_32(srr0), *addr);
 		c->mov(*addr, qw0->r32());
-		c->mov(x86::r10, x86::qword_ptr(*cpu, offset32(&SPUThread::jit_dispatcher)));
+		c->mov(x86::r10, SPU_OFF_64(jit_dispatcher));
+		c->mov(x86::r10, x86::qword_ptr(x86::r10));
 		c->align(kAlignCode, 16);
 		c->bind(no_intr);
 	}
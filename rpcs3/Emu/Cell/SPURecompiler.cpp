@@ -1,6 +1,7 @@
 ﻿#include "stdafx.h"
 #include "Emu/System.h"
 #include "Emu/IdManager.h"
+#include "Emu/Benchmark.h"
 #include "Emu/Memory/Memory.h"
 #include "Crypto/sha1.h"
 #include "Utilities/StrUtil.h"
@@ -113,7 +114,7 @@ void spu_cache::initialize()
 	// Recompiler instance for cache initialization
 	std::unique_ptr<spu_recompiler_base> compiler;
 
-	if (g_cfg.core.spu_decoder == spu_decoder_type::asmjit)
+	if (g_cfg.core.spu_decoder == spu_decoder_type::asmjit || spu_tier_runtime::enabled())
 	{
 		if (g_cfg.core.spu_debug)
 		{
@@ -123,7 +124,7 @@ void spu_cache::initialize()
 		compiler = spu_recompiler_base::make_asmjit_recompiler();
 	}
 
-	if (g_cfg.core.spu_decoder == spu_decoder_type::llvm)
+	if (g_cfg.core.spu_decoder == spu_decoder_type::llvm && !spu_tier_runtime::enabled())
 	{
 		compiler = spu_recompiler_base::make_llvm_recompiler();
 	}
@@ -197,6 +198,387 @@ void spu_cache::initialize()
 	});
 }
 
+spu_dispatch_table::spu_dispatch_table()
+{
+	for (auto& v : data)
+	{
+		v.raw() = &spu_recompiler_base::dispatch;
+	}
+}
+
+spu_dispatch_table::spu_dispatch_table(const spu_dispatch_table& other)
+	: image(other.image)
+	, program(other.program)
+{
+	for (u32 i = 0; i < data.size(); i++)
+	{
+		data[i].raw() = other.data[i].load();
+	}
+}
+
+std::shared_ptr<spu_dispatch_table> spu_dispatch_cache::get(u64 image_hash)
+{
+	// Trampolines of different runtimes can't be mixed
+	if (!image_hash || !g_cfg.core.spu_shared_runtime)
+	{
+		return std::make_shared<spu_dispatch_table>();
+	}
+
+	const auto _this = fxm::get_always<spu_dispatch_cache>();
+
+	writer_lock lock(_this->m_mutex);
+
+	auto& table = _this->m_tables[std::make_pair(image_hash, u64{0})];
+
+	if (!table)
+	{
+		table = std::make_shared<spu_dispatch_table>();
+		table->image = image_hash;
+	}
+
+	return table;
+}
+
+std::shared_ptr<spu_dispatch_table> spu_dispatch_cache::fork(const spu_dispatch_table& base, const std::vector<u32>& func)
+{
+	// Identify the program by the content of the diverging block
+	sha1_context ctx;
+	u8 output[20];
+
+	sha1_starts(&ctx);
+	sha1_update(&ctx, reinterpret_cast<const u8*>(func.data()), func.size() * 4);
+	sha1_finish(&ctx, output);
+
+	u64 hash;
+	std::memcpy(&hash, output, sizeof(hash));
+
+	// Reserve 0 for the initial table
+	hash |= 1;
+
+	const auto _this = fxm::get_always<spu_dispatch_cache>();
+
+	{
+		reader_lock lock(_this->m_mutex);
+
+		const auto found = _this->m_tables.find(std::make_pair(base.image, hash));
+
+		if (found != _this->m_tables.end())
+		{
+			return found->second;
+		}
+	}
+
+	// Copy the table without holding the lock
+	auto table = std::make_shared<spu_dispatch_table>(base);
+	table->program = hash;
+
+	writer_lock lock(_this->m_mutex);
+
+	const auto found = _this->m_tables.find(std::make_pair(base.image, hash));
+
+	if (found != _this->m_tables.end())
+	{
+		return found->second;
+	}
+
+	// Limit memory usage (512 KiB per table)
+	const auto begin = _this->m_tables.lower_bound(std::make_pair(base.image, u64{0}));
+	const auto end = _this->m_tables.upper_bound(std::make_pair(base.image, UINT64_MAX));
+
+	if (std::distance(begin, end) >= max_programs)
+	{
+		// Threads using the tables of the image will make private copies without forking
+		for (auto it = begin; it != end; it++)
+		{
+			it->second->full = true;
+		}
+
+		table->image = 0;
+		return table;
+	}
+
+	_this->m_tables.emplace(std::make_pair(base.image, hash), table);
+	LOG_NOTICE(SPU, "Dispatch table forked for image 0x%016llx (program 0x%016llx)", base.image, hash);
+	return table;
+}
+
+std::shared_ptr<spu_dispatch_table> spu_dispatch_cache::copy(const spu_dispatch_table& base)
+{
+	auto table = std::make_shared<spu_dispatch_table>(base);
+	table->image = 0;
+	table->program = 0;
+	return table;
+}
+
+spu_dispatch_table& spu_dispatch_cache::empty()
+{
+	static spu_dispatch_table table;
+	return table;
+}
+
+bool spu_tier_runtime::enabled()
+{
+	return g_cfg.core.spu_decoder == spu_decoder_type::llvm && g_cfg.core.spu_tiered;
+}
+
+spu_tier_entry* spu_tier_runtime::get(const std::vector<u32>& func)
+{
+	writer_lock lock(m_mutex);
+
+	return &m_entries[func];
+}
+
+void spu_tier_runtime::push(std::vector<u32>&& func)
+{
+	if (func.empty())
+	{
+		return;
+	}
+
+	{
+		writer_lock lock(m_mutex);
+		m_queue.emplace_back(std::move(func));
+	}
+
+	notify();
+}
+
+void spu_tier_runtime::promote(SPUThread& spu, void*, u8* rip)
+{
+	if (const auto _this = fxm::get<spu_tier_runtime>())
+	{
+		// Analyse the block again (pc is set to the block start)
+		_this->push(spu.jit->block(spu._ptr<u32>(0), spu.pc));
+	}
+}
+
+void spu_tier_runtime::on_stop()
+{
+	{
+		writer_lock lock(m_mutex);
+		m_stop = true;
+	}
+
+	notify();
+	named_thread::on_stop();
+}
+
+void spu_tier_runtime::on_task()
+{
+	// Set low priority
+	thread_ctrl::set_native_priority(-1);
+
+	// LLVM recompiler instance (only used in this thread)
+	const auto compiler = spu_recompiler_base::make_llvm_recompiler();
+	compiler->init();
+
+	while (!Emu.IsStopped())
+	{
+		std::vector<u32> func;
+
+		{
+			writer_lock lock(m_mutex);
+
+			if (m_stop)
+			{
+				break;
+			}
+
+			if (!m_queue.empty())
+			{
+				func = std::move(m_queue.front());
+				m_queue.pop_front();
+			}
+		}
+
+		if (func.empty())
+		{
+			thread_ctrl::wait();
+			continue;
+		}
+
+		const u32 start = func[0];
+
+		// Compile (copy of the block is used as the key)
+		const auto fn = compiler->compile(std::vector<u32>(func));
+
+		if (!fn)
+		{
+			continue;
+		}
+
+		reader_lock lock(m_mutex);
+
+		const auto found = m_entries.find(func);
+
+		if (found != m_entries.end())
+		{
+			// Baseline function starts jumping to the new one
+			found->second.func = fn;
+			LOG_NOTICE(SPU, "[0x%x] Promoted to LLVM: %p", start, fn);
+		}
+	}
+}
+
+spu_profiler::spu_profiler()
+{
+	if (const auto _main = fxm::check_unlocked<ppu_module>())
+	{
+		m_dir = _main->cache;
+	}
+
+	LOG_SUCCESS(SPU, "SPU Profiler initialized...");
+}
+
+spu_profiler::~spu_profiler()
+{
+	dump();
+}
+
+bool spu_profiler::enabled()
+{
+	return g_cfg.core.spu_profiler && (g_cfg.core.spu_decoder == spu_decoder_type::asmjit || g_cfg.core.spu_decoder == spu_decoder_type::llvm);
+}
+
+spu_profile_entry* spu_profiler::get(const std::vector<u32>& func)
+{
+	// Identify the block by its content
+	sha1_context ctx;
+	u8 output[20];
+
+	sha1_starts(&ctx);
+	sha1_update(&ctx, reinterpret_cast<const u8*>(func.data() + 1), func.size() * 4 - 4);
+	sha1_finish(&ctx, output);
+
+	u64 hash;
+	std::memcpy(&hash, output, sizeof(hash));
+
+	// Attribute the block to the program running on the compiling thread (tier thread doesn't have one)
+	u64 program = 0;
+
+	if (const auto cpu = get_current_cpu_thread())
+	{
+		if (cpu->id_type() == 2)
+		{
+			program = static_cast<SPUThread*>(cpu)->image_hash;
+		}
+	}
+
+	writer_lock lock(m_mutex);
+
+	const auto found = m_entries.emplace(std::make_pair(func[0], hash), spu_profile_entry{});
+
+	if (found.second)
+	{
+		found.first->second.program = program;
+	}
+
+	return &found.first->second;
+}
+
+void spu_profiler::enter(SPUThread& spu, spu_profile_entry* entry)
+{
+	entry->count++;
+
+	if (g_cfg.core.spu_profiler_cycles)
+	{
+		const u64 stamp = __rdtsc();
+
+		if (spu.profile_last)
+		{
+			spu.profile_last->cycles += stamp - spu.profile_tsc;
+		}
+
+		spu.profile_tsc = stamp;
+		spu.profile_last = entry;
+	}
+}
+
+bool spu_profiler::dump()
+{
+	if (m_dir.empty())
+	{
+		return false;
+	}
+
+	struct record
+	{
+		u32 addr;
+		u64 hash;
+		spu_profile_entry data;
+	};
+
+	// Program hash -> executed blocks
+	std::map<u64, std::vector<record>> programs;
+
+	{
+		reader_lock lock(m_mutex);
+
+		for (const auto& pair : m_entries)
+		{
+			if (pair.second.count)
+			{
+				programs[pair.second.program].push_back(record{pair.first.first, pair.first.second, pair.second});
+			}
+		}
+	}
+
+	bool result = true;
+
+	for (auto& program : programs)
+	{
+		auto& list = program.second;
+
+		u64 total_count = 0;
+		u64 total_cycles = 0;
+
+		for (const auto& r : list)
+		{
+			total_count += r.data.count;
+			total_cycles += r.data.cycles;
+		}
+
+		// Hottest blocks first
+		std::sort(list.begin(), list.end(), [&](const record& a, const record& b)
+		{
+			if (total_cycles && a.data.cycles != b.data.cycles)
+			{
+				return a.data.cycles > b.data.cycles;
+			}
+
+			return a.data.count > b.data.count;
+		});
+
+		std::string report;
+		fmt::append(report, "SPU Profile (program %016x): %u blocks, %u executions, %u cycles\n\n", program.first, list.size(), total_count, total_cycles);
+		fmt::append(report, "%-8s %-16s %16s %8s %20s %8s\n", "Address", "Hash", "Count", "Count%", "Cycles", "Cycles%");
+
+		for (const auto& r : list)
+		{
+			const double pcount = total_count ? r.data.count * 100. / total_count : 0.;
+			const double pcycles = total_cycles ? r.data.cycles * 100. / total_cycles : 0.;
+			fmt::append(report, "0x%05x  %016x %16u %7.3f%% %20u %7.3f%%\n", r.addr, r.hash, r.data.count, pcount, r.data.cycles, pcycles);
+		}
+
+		const std::string path = fmt::format("%sspu-profile-%016x.log", m_dir, program.first);
+
+		fs::file out(path, fs::rewrite);
+
+		if (!out)
+		{
+			LOG_ERROR(SPU, "Failed to write SPU profile: %s (%s)", path, fs::g_tls_error);
+			result = false;
+			continue;
+		}
+
+		out.write(report);
+
+		LOG_SUCCESS(SPU, "SPU profile written (%u blocks): %s", list.size(), path);
+	}
+
+	return result;
+}
+
 spu_recompiler_base::spu_recompiler_base()
 {
 }
@@ -222,7 +604,7 @@ void spu_recompiler_base::dispatch(SPUThread& spu, void*, u8* rip)
 	// First attempt (load new trampoline and retry)
 	if (func != spu.jit_dispatcher[spu.pc / 4])
 	{
-		spu.jit_dispatcher[spu.pc / 4] = func;
+		spu.set_dispatch(spu.pc, func);
 		return;
 	}
 
@@ -235,14 +617,14 @@ void spu_recompiler_base::dispatch(SPUThread& spu, void*, u8* rip)
 
 	// Compile
 	verify(HERE), spu.jit->compile(spu.jit->block(spu._ptr<u32>(0), spu.pc));
-	spu.jit_dispatcher[spu.pc / 4] = spu.jit->get(spu.pc);
+	spu.set_dispatch(spu.pc, spu.jit->get(spu.pc));
 }
 
 void spu_recompiler_base::branch(SPUThread& spu, void*, u8* rip)
 {
 	// Compile
 	const auto func = verify(HERE, spu.jit->compile(spu.jit->block(spu._ptr<u32>(0), spu.pc)));
-	spu.jit_dispatcher[spu.pc / 4] = spu.jit->get(spu.pc);
+	spu.set_dispatch(spu.pc, spu.jit->get(spu.pc));
 
 	// Overwrite jump to this function with jump to the compiled function
 	const s64 rel = reinterpret_cast<u64>(func) - reinterpret_cast<u64>(rip) - 5;
@@ -1207,6 +1589,11 @@ public:
 			m_spurt = fxm::get_always<spu_llvm_runtime>();
 			m_context = m_spurt->m_jit.get_context();
 		}
+
+		if (!m_profiler && spu_profiler::enabled())
+		{
+			m_profiler = fxm::get_always<spu_profiler>();
+		}
 	}
 
 	virtual spu_function_t get(u32 lsa) override
@@ -1236,9 +1623,12 @@ public:
 
 		if (fn_location)
 		{
+			g_jit_counters.spu_cached++;
 			return fn_location;
 		}
 
+		const u64 compile_start = get_system_time();
+
 		auto& func = fn_info.first->first;
 
 		std::string hash;
@@ -1275,9 +1665,8 @@ public:
 		// Initialize pass manager
 		legacy::FunctionPassManager pm(module.get());
 
-		// Basic optimizations
-		pm.add(createEarlyCSEPass());
-		pm.add(createDeadStoreEliminationPass());
+		// Optimization passes for the selected tier
+		llvm_add_opt_passes(pm, g_cfg.core.llvm_opt);
 		pm.add(createLintPass()); // Check
 
 		// Add function
@@ -1411,6 +1800,22 @@ public:
 		const auto pbcount = spu_ptr<u64>(&SPUThread::block_counter);
 		m_ir->CreateStore(m_ir->CreateAdd(m_ir->CreateLoad(pbcount), m_ir->getInt64(1)), pbcount);
 
+		if (m_profiler)
+		{
+			// Update block statistics
+			const auto entry = m_profiler->get(func);
+
+			if (g_cfg.core.spu_profiler_cycles)
+			{
+				call(&exec_profile, m_thread, m_ir->getInt64(reinterpret_cast<u64>(entry)));
+			}
+			else
+			{
+				const auto pcount = m_ir->CreateIntToPtr(m_ir->getInt64(reinterpret_cast<u64>(&entry->count)), get_type<u64*>());
+				m_ir->CreateStore(m_ir->CreateAdd(m_ir->CreateLoad(pcount), m_ir->getInt64(1)), pcount);
+			}
+		}
+
 		// Emit instructions
 		for (u32 i = 1; i < func.size(); i++)
 		{
@@ -1716,11 +2121,14 @@ public:
 			fs::file(m_spurt->m_cache_path + "../spu.log", fs::write + fs::append).write(log);
 		}
 
-		if (m_cache && g_cfg.core.spu_cache)
+		// In tiered mode, the block is already cached by the baseline recompiler
+		if (m_cache && g_cfg.core.spu_cache && !spu_tier_runtime::enabled())
 		{
 			m_cache->add(func);
 		}
 
+		g_jit_counters.spu_compiled++;
+		g_jit_counters.spu_time += get_system_time() - compile_start;
 		return fn;
 	}
 
@@ -1729,6 +2137,11 @@ public:
 		return _spu->check_state();
 	}
 
+	static void exec_profile(SPUThread* _spu, spu_profile_entry* entry)
+	{
+		spu_profiler::enter(*_spu, entry);
+	}
+
 	template <spu_inter_func_t F>
 	static void exec_fall(SPUThread* _spu, spu_opcode_t op)
 	{
@@ -3084,7 +3497,7 @@ public:
 			m_ir->SetInsertPoint(exter);
 		}
 
-		const auto disp = m_ir->CreateAdd(m_thread, m_ir->getInt64(::offset32(&SPUThread::jit_dispatcher)));
+		const auto disp = m_ir->CreateLoad(spu_ptr<u64>(&SPUThread::jit_dispatcher));
 		const auto type = llvm::FunctionType::get(get_type<void>(), {get_type<u64>(), get_type<u64>(), get_type<u32>()}, false)->getPointerTo()->getPointerTo();
 		tail(m_ir->CreateLoad(m_ir->CreateIntToPtr(m_ir->CreateAdd(disp, zext<u64>(addr << 1).value), type)));
 	}
@@ -3100,7 +3513,7 @@ public:
 		}
 
 		m_ir->CreateStore(m_ir->getInt32(target), spu_ptr<u32>(&SPUThread::pc));
-		const auto addr = m_ir->CreateAdd(m_thread, m_ir->getInt64(::offset32(&SPUThread::jit_dispatcher) + target * 2));
+		const auto addr = m_ir->CreateAdd(m_ir->CreateLoad(spu_ptr<u64>(&SPUThread::jit_dispatcher)), m_ir->getInt64(target * 2));
 		const auto type = llvm::FunctionType::get(get_type<void>(), {get_type<u64>(), get_type<u64>(), get_type<u32>()}, false)->getPointerTo()->getPointerTo();
 		const auto func = m_ir->CreateLoad(m_ir->CreateIntToPtr(addr, type));
 		tail(func);
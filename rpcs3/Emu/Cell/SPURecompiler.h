@@ -1,9 +1,12 @@
 #pragma once
 
 #include "Utilities/File.h"
+#include "Utilities/mutex.h"
 #include "SPUThread.h"
 #include <vector>
 #include <bitset>
+#include <deque>
+#include <map>
 #include <memory>
 #include <string>
 
@@ -29,6 +32,129 @@ public:
 	static void initialize();
 };
 
+// Dispatch table for indirect branches (shared by SPU threads running the same program)
+struct spu_dispatch_table
+{
+	std::array<atomic_t<spu_function_t>, 0x10000> data;
+
+	u64 image = 0; // Image hash (0 for private tables)
+	u64 program = 0; // Hash of the first diverging block (0 for the initial table of the image)
+	atomic_t<bool> full{false}; // Set when the image has too many tables (private copies are made instead)
+
+	spu_dispatch_table();
+
+	// Copy entries of another table
+	spu_dispatch_table(const spu_dispatch_table&);
+};
+
+// Dispatch tables of SPU images
+class spu_dispatch_cache
+{
+	shared_mutex m_mutex;
+
+	// Image hash, program hash -> table
+	std::map<std::pair<u64, u64>, std::shared_ptr<spu_dispatch_table>> m_tables;
+
+public:
+	// Max number of tables per image
+	static constexpr u32 max_programs = 16;
+
+	// Get table for the image (creates private table if hash is 0 or the runtime is not shared)
+	static std::shared_ptr<spu_dispatch_table> get(u64 image_hash);
+
+	// Get table for another program running on the same image (copy of the base, private if there are too many)
+	static std::shared_ptr<spu_dispatch_table> fork(const spu_dispatch_table& base, const std::vector<u32>& func);
+
+	// Get private copy of the table
+	static std::shared_ptr<spu_dispatch_table> copy(const spu_dispatch_table& base);
+
+	// Get empty table which is never written (used until the thread needs its own one)
+	static spu_dispatch_table& empty();
+};
+
+// Execution counter and promoted function of the block (tiered compilation)
+struct spu_tier_entry
+{
+	u64 count = 0; // Not atomic (approximate)
+	atomic_t<spu_function_t> func{};
+	atomic_t<u32> queued{0}; // Bit 0 set when the promotion is requested
+};
+
+// Tiered compilation runtime: hot blocks compiled by ASMJIT are recompiled by LLVM in background
+class spu_tier_runtime final : public named_thread
+{
+	shared_mutex m_mutex;
+
+	// Counters for all blocks compiled by the baseline recompiler
+	std::map<std::vector<u32>, spu_tier_entry> m_entries;
+
+	// Blocks waiting for recompilation
+	std::deque<std::vector<u32>> m_queue;
+
+	bool m_stop = false;
+
+	void on_task() override;
+
+	std::string get_name() const override
+	{
+		return "SPU Tier Compiler";
+	}
+
+	void push(std::vector<u32>&& func);
+
+public:
+	void on_stop() override;
+
+	// Get block entry (the pointer is stable)
+	spu_tier_entry* get(const std::vector<u32>& func);
+
+	// Target for the block which reached the threshold (second arg is unused)
+	static void promote(SPUThread&, void*, u8* rip);
+
+	// Check whether tiered compilation is enabled
+	static bool enabled();
+};
+
+// Execution statistics of the block (profiler)
+struct spu_profile_entry
+{
+	u64 count = 0;
+	u64 cycles = 0; // Approximate, attributed on entry to the next block
+	u64 program = 0; // Image hash of the SPU program which compiled the block first
+};
+
+// Per-block SPU execution profiler (shared by all recompilers)
+class spu_profiler
+{
+	shared_mutex m_mutex;
+
+	// Block start address and content hash -> statistics
+	std::map<std::pair<u32, u64>, spu_profile_entry> m_entries;
+
+	// Report directory
+	std::string m_dir;
+
+public:
+	spu_profiler();
+
+	spu_profiler(const spu_profiler&) = delete;
+
+	// Write the report on exit
+	~spu_profiler();
+
+	// Get block entry (the pointer is stable)
+	spu_profile_entry* get(const std::vector<u32>& func);
+
+	// Write sorted reports (one file per SPU program)
+	bool dump();
+
+	// Block entry hook for cycle counting
+	static void enter(SPUThread&, spu_profile_entry*);
+
+	// Check whether the profiler is enabled
+	static bool enabled();
+};
+
 // SPU Recompiler instance base class
 class spu_recompiler_base
 {
@@ -50,6 +176,12 @@ protected:
 
 	std::shared_ptr<spu_cache> m_cache;
 
+	// Tiered compilation runtime (baseline recompiler only)
+	std::shared_ptr<spu_tier_runtime> m_tier;
+
+	// Block profiler (if enabled)
+	std::shared_ptr<spu_profiler> m_profiler;
+
 private:
 	// For private use
 	std::bitset<0x10000> m_bits;
@@ -394,6 +394,8 @@ spu_imm_table_t::spu_imm_table_t()
 
 void SPUThread::on_spawn()
 {
+	thread_ctrl::set_class(thread_class::spu);
+
 	if (g_cfg.core.thread_scheduler_enabled)
 	{
 		thread_ctrl::set_thread_affinity_mask(thread_ctrl::get_affinity_mask(thread_class::spu));
@@ -453,6 +455,35 @@ std::string SPUThread::dump() const
 	return ret;
 }
 
+void SPUThread::set_dispatch_table(u64 image_hash)
+{
+	jit_table = spu_dispatch_cache::get(image_hash);
+	jit_dispatcher = jit_table->data.data();
+}
+
+void SPUThread::set_dispatch(u32 ls_pc, spu_function_t func)
+{
+	if (!jit_table)
+	{
+		// Leave the empty table on the first write
+		set_dispatch_table(0);
+	}
+	else if (jit_table->image)
+	{
+		const auto old = jit_dispatcher[ls_pc / 4].load();
+
+		// Different code at the same address: don't overwrite entries used by other programs
+		if (old != &spu_recompiler_base::dispatch && old != func)
+		{
+			// Don't hash the block again if the image can't have more tables
+			jit_table = jit_table->full ? spu_dispatch_cache::copy(*jit_table) : spu_dispatch_cache::fork(*jit_table, jit->block(_ptr<u32>(0), ls_pc));
+			jit_dispatcher = jit_table->data.data();
+		}
+	}
+
+	jit_dispatcher[ls_pc / 4] = func;
+}
+
 void SPUThread::cpu_init()
 {
 	gpr = {};
@@ -631,20 +662,19 @@ SPUThread::SPUThread(const std::string& name, u32 index, lv2_spu_group* group)
 	, offset(0)
 	, group(group)
 {
-	if (g_cfg.core.spu_decoder == spu_decoder_type::asmjit)
+	if (g_cfg.core.spu_decoder == spu_decoder_type::asmjit || spu_tier_runtime::enabled())
 	{
 		jit = spu_recompiler_base::make_asmjit_recompiler();
 	}
-
-	if (g_cfg.core.spu_decoder == spu_decoder_type::llvm)
+	else if (g_cfg.core.spu_decoder == spu_decoder_type::llvm)
 	{
 		jit = spu_recompiler_base::make_llvm_recompiler();
 	}
 
 	if (g_cfg.core.spu_decoder != spu_decoder_type::fast && g_cfg.core.spu_decoder != spu_decoder_type::precise)
 	{
-		// Initialize lookup table
-		jit_dispatcher.fill(&spu_recompiler_base::dispatch);
+		// Use empty lookup table (replaced with the shared one when the image is known, or with a private one on the first write)
+		jit_dispatcher = spu_dispatch_cache::empty().data.data();
 
 		if (g_cfg.core.spu_block_size != spu_block_size_type::safe)
 		{
@@ -1021,6 +1051,8 @@ void SPUThread::do_putlluc(const spu_mfc_cmd& args)
 		{
 			LOG_ERROR(SPU, "%s took too long: %u", args.cmd, count);
 		}
+
+		vm::reservation_wake(addr);
 	}
 	else
 	{
@@ -1175,22 +1207,29 @@ bool SPUThread::process_mfc_cmd(spu_mfc_cmd args)
 			ch_event_stat |= SPU_EVENT_LR;
 		}
 
+		// Detect wait loop: the same reservation is read again while nothing has changed (ignoring the lock bit)
+		if (raddr == args.eal && rtime == (vm::reservation_acquire(raddr, 128) & -2) && rdata == data)
+		{
+			rpolls++;
+		}
+		else
+		{
+			rpolls = 0;
+		}
+
 		raddr = args.eal;
 
-		const bool is_polling = false; // TODO
+		const bool is_polling = g_cfg.core.spu_loop_detection && rpolls >= 4;
 
 		if (is_polling)
 		{
-			rtime = vm::reservation_acquire(raddr, 128);
+			const u64 stamp = vm::reservation_acquire(raddr, 128);
 
-			while (rdata == data && vm::reservation_acquire(raddr, 128) == rtime)
+			// Sleep once until the reservation is updated, then return to the SPU (it may be waiting for an event, a signal or the decrementer)
+			// The timeout catches plain stores which don't update the stamp; a locked line waits for the writer's update
+			if (rdata == data && (stamp & -2) == rtime && !test(state))
 			{
-				if (test(state, cpu_flag::stop))
-				{
-					break;
-				}
-
-				thread_ctrl::wait_for(100);
+				vm::reservation_wait(raddr, stamp, 100);
 			}
 		}
 
@@ -1267,6 +1306,7 @@ bool SPUThread::process_mfc_cmd(spu_mfc_cmd args)
 			{
 				if (spu_putllc_tx(raddr, rtime, rdata.data(), to_write.data()))
 				{
+					vm::reservation_wake(raddr);
 					vm::reservation_notifier(raddr, 128).notify_all();
 					result = true;
 				}
@@ -513,6 +513,12 @@ public:
 	virtual ~SPUThread() override;
 	void cpu_init();
 
+	// Select dispatch table for the SPU image (0 = private table)
+	void set_dispatch_table(u64 image_hash);
+
+	// Write dispatch table entry (copies the table if it's shared with a different program)
+	void set_dispatch(u32 ls_pc, spu_function_t func);
+
 	static const u32 id_base = 0x02000000; // TODO (used to determine thread type)
 	static const u32 id_step = 1;
 	static const u32 id_count = 2048;
@@ -539,6 +545,7 @@ public:
 	u64 rtime = 0;
 	std::array<u128, 8> rdata{};
 	u32 raddr = 0;
+	u32 rpolls = 0; // Consecutive GETLLAR of unchanged reservation
 
 	u32 srr0;
 	u32 ch_tag_upd;
@@ -586,7 +593,13 @@ public:
 	u64 block_recover = 0;
 	u64 block_failure = 0;
 
-	std::array<spu_function_t, 0x10000> jit_dispatcher; // Dispatch table for indirect calls
+	u64 image_hash = 0; // Hash of the SPU image (program) running on the thread, 0 if unknown
+
+	u64 profile_tsc = 0; // Timestamp of the last profiled block entry
+	struct spu_profile_entry* profile_last = nullptr; // Last profiled block
+
+	std::shared_ptr<struct spu_dispatch_table> jit_table; // Dispatch table owner (may be shared)
+	atomic_t<spu_function_t>* jit_dispatcher = nullptr; // Dispatch table for indirect calls
 
 	std::array<v128, 0x4000> stack_mirror; // Return address information
 
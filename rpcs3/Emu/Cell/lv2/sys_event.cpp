@@ -369,7 +369,7 @@ error_code sys_event_port_connect_local(u32 eport_id, u32 equeue_id)
 {
 	sys_event.warning("sys_event_port_connect_local(eport_id=0x%x, equeue_id=0x%x)", eport_id, equeue_id);
 
-	writer_lock lock(id_manager::g_mutex);
+	id_manager::global_writer_lock lock;
 
 	const auto port = idm::check_unlocked<lv2_obj, lv2_event_port>(eport_id);
 
@@ -399,7 +399,7 @@ error_code sys_event_port_connect_ipc(u32 eport_id, u64 ipc_key)
 
 	auto queue = lv2_event_queue::find(ipc_key);
 
-	writer_lock lock(id_manager::g_mutex);
+	id_manager::global_writer_lock lock;
 
 	const auto port = idm::check_unlocked<lv2_obj, lv2_event_port>(eport_id);
 
@@ -427,7 +427,7 @@ error_code sys_event_port_disconnect(u32 eport_id)
 {
 	sys_event.warning("sys_event_port_disconnect(eport_id=0x%x)", eport_id);
 
-	writer_lock lock(id_manager::g_mutex);
+	id_manager::global_writer_lock lock;
 
 	const auto port = idm::check_unlocked<lv2_obj, lv2_event_port>(eport_id);
 
@@ -71,7 +71,7 @@ void sys_spu_image::free()
 	}
 }
 
-void sys_spu_image::deploy(u32 loc, sys_spu_segment* segs, u32 nsegs)
+u64 sys_spu_image::deploy(u32 loc, sys_spu_segment* segs, u32 nsegs)
 {
 	// Segment info dump
 	std::string dump;
@@ -137,6 +137,10 @@ void sys_spu_image::deploy(u32 loc, sys_spu_segment* segs, u32 nsegs)
 	}
 
 	LOG_NOTICE(LOADER, "Loaded SPU image: %s (<- %u)%s", hash, applied, dump);
+
+	u64 result;
+	std::memcpy(&result, sha1_hash, sizeof(result));
+	return result;
 }
 
 error_code sys_spu_initialize(u32 max_usable_spu, u32 max_raw_spu)
@@ -382,7 +386,15 @@ error_code sys_spu_thread_group_start(ppu_thread& ppu, u32 id)
 			auto& args = group->args[thread->index];
 			auto& img = group->imgs[thread->index];
 
-			sys_spu_image::deploy(thread->offset, img.second.data(), img.first.nsegs);
+			const u64 image_hash = sys_spu_image::deploy(thread->offset, img.second.data(), img.first.nsegs);
+
+			thread->image_hash = image_hash;
+
+			if (thread->jit)
+			{
+				// Share indirect branch table with other threads running the same image
+				thread->set_dispatch_table(image_hash);
+			}
 
 			thread->pc = img.first.entry_point;
 			thread->cpu_init();
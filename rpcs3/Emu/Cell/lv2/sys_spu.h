@@ -197,7 +197,7 @@ struct sys_spu_image
 
 	void load(const fs::file& stream);
 	void free();
-	static void deploy(u32 loc, sys_spu_segment* segs, u32 nsegs);
+	static u64 deploy(u32 loc, sys_spu_segment* segs, u32 nsegs); // Returns image hash (first 8 bytes of SHA-1)
 };
 
 enum : u32
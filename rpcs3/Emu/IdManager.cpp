@@ -3,6 +3,8 @@
 
 shared_mutex id_manager::g_mutex;
 
+std::array<shared_mutex, 64> id_manager::g_type_mutex;
+
 thread_local DECLARE(idm::g_id);
 DECLARE(idm::g_map);
 DECLARE(fxm::g_vec);
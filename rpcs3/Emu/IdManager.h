@@ -5,13 +5,65 @@
 
 #include <memory>
 #include <vector>
+#include <array>
 
 // Helper namespace
 namespace id_manager
 {
-	// Common global mutex
+	// Common global mutex (taken exclusively by writers, reader lock gives stable access to objects of all types)
 	extern shared_mutex g_mutex;
 
+	// Per-type mutexes (indexed by type index modulo size): lookups only lock the mutex of their type
+	extern std::array<shared_mutex, 64> g_type_mutex;
+
+	inline shared_mutex& get_type_mutex(u32 type)
+	{
+		return g_type_mutex[type % g_type_mutex.size()];
+	}
+
+	// Exclusive access to objects of specified type (also excludes g_mutex readers)
+	class type_writer_lock final
+	{
+		writer_lock m_global;
+		writer_lock m_type;
+
+	public:
+		explicit type_writer_lock(u32 type)
+			: m_global(g_mutex)
+			, m_type(get_type_mutex(type))
+		{
+		}
+
+		type_writer_lock(const type_writer_lock&) = delete;
+	};
+
+	// Exclusive access to objects of all types (for operations involving several types)
+	class global_writer_lock final
+	{
+	public:
+		global_writer_lock()
+		{
+			g_mutex.lock();
+
+			for (auto& mutex : g_type_mutex)
+			{
+				mutex.lock();
+			}
+		}
+
+		global_writer_lock(const global_writer_lock&) = delete;
+
+		~global_writer_lock()
+		{
+			for (auto& mutex : g_type_mutex)
+			{
+				mutex.unlock();
+			}
+
+			g_mutex.unlock();
+		}
+	};
+
 	// ID traits
 	template <typename T, typename = void>
 	struct id_traits
@@ -307,7 +359,7 @@ class idm
 		using traits = id_manager::id_traits<Type>;
 
 		// Allocate new id
-		writer_lock lock(id_manager::g_mutex);
+		id_manager::type_writer_lock lock(get_type<T>());
 
 		if (auto* place = allocate_id(info, traits::base, traits::step, traits::count))
 		{
@@ -411,7 +463,7 @@ public:
 	template <typename T, typename Get = T>
 	static inline Get* check(u32 id)
 	{
-		reader_lock lock(id_manager::g_mutex);
+		reader_lock lock(id_manager::get_type_mutex(get_type<T>()));
 
 		return check_unlocked<T, Get>(id);
 	}
@@ -420,7 +472,7 @@ public:
 	template <typename T, typename Get = T, typename F, typename FRT = std::result_of_t<F(Get&)>, typename = std::enable_if_t<std::is_void<FRT>::value>>
 	static inline Get* check(u32 id, F&& func, int = 0)
 	{
-		reader_lock lock(id_manager::g_mutex);
+		reader_lock lock(id_manager::get_type_mutex(get_type<T>()));
 
 		if (const auto ptr = check_unlocked<T, Get>(id))
 		{
@@ -435,7 +487,7 @@ public:
 	template <typename T, typename Get = T, typename F, typename FRT = std::result_of_t<F(Get&)>, typename = std::enable_if_t<!std::is_void<FRT>::value>>
 	static inline return_pair<Get*, FRT> check(u32 id, F&& func)
 	{
-		reader_lock lock(id_manager::g_mutex);
+		reader_lock lock(id_manager::get_type_mutex(get_type<T>()));
 
 		if (const auto ptr = check_unlocked<T, Get>(id))
 		{
@@ -463,7 +515,7 @@ public:
 	template <typename T, typename Get = T>
 	static inline std::shared_ptr<Get> get(u32 id)
 	{
-		reader_lock lock(id_manager::g_mutex);
+		reader_lock lock(id_manager::get_type_mutex(get_type<T>()));
 
 		const auto found = find_id<T, Get>(id);
 
@@ -481,7 +533,7 @@ public:
 	{
 		using result_type = std::shared_ptr<Get>;
 
-		reader_lock lock(id_manager::g_mutex);
+		reader_lock lock(id_manager::get_type_mutex(get_type<T>()));
 
 		const auto found = find_id<T, Get>(id);
 
@@ -503,7 +555,7 @@ public:
 	{
 		using result_type = return_pair<Get, FRT>;
 
-		reader_lock lock(id_manager::g_mutex);
+		reader_lock lock(id_manager::get_type_mutex(get_type<T>()));
 
 		const auto found = find_id<T, Get>(id);
 
@@ -523,7 +575,7 @@ public:
 	{
 		static_assert(id_manager::id_verify<T, Get>::value, "Invalid ID type combination");
 
-		reader_lock lock(id_manager::g_mutex);
+		reader_lock lock(id_manager::get_type_mutex(get_type<T>()));
 
 		u32 result = 0;
 
@@ -551,7 +603,7 @@ public:
 		using object_type = typename function_traits<FT>::object_type;
 		using result_type = return_pair<object_type, FRT>;
 
-		reader_lock lock(id_manager::g_mutex);
+		reader_lock lock(id_manager::get_type_mutex(get_type<T>()));
 
 		for (auto& id : g_map[get_type<T>()])
 		{
@@ -576,7 +628,7 @@ public:
 	{
 		std::shared_ptr<void> ptr;
 		{
-			writer_lock lock(id_manager::g_mutex);
+			id_manager::type_writer_lock lock(get_type<T>());
 
 			if (const auto found = find_id<T, Get>(id))
 			{
@@ -598,7 +650,7 @@ public:
 	{
 		std::shared_ptr<void> ptr;
 		{
-			writer_lock lock(id_manager::g_mutex);
+			id_manager::type_writer_lock lock(get_type<T>());
 
 			if (const auto found = find_id<T, Get>(id))
 			{
@@ -622,7 +674,7 @@ public:
 
 		std::shared_ptr<void> ptr;
 		{
-			writer_lock lock(id_manager::g_mutex);
+			id_manager::type_writer_lock lock(get_type<T>());
 
 			if (const auto found = find_id<T, Get>(id))
 			{
@@ -649,7 +701,7 @@ public:
 		std::shared_ptr<void> ptr;
 		FRT ret;
 		{
-			writer_lock lock(id_manager::g_mutex);
+			id_manager::type_writer_lock lock(get_type<T>());
 
 			if (const auto found = find_id<T, Get>(id))
 			{
@@ -700,7 +752,7 @@ public:
 	{
 		std::shared_ptr<T> ptr;
 		{
-			writer_lock lock(id_manager::g_mutex);
+			id_manager::type_writer_lock lock(get_type<T>());
 
 			auto& pair = g_vec[get_type<T>()];
 
@@ -728,7 +780,7 @@ public:
 		std::shared_ptr<T> ptr;
 		std::shared_ptr<void> old;
 		{
-			writer_lock lock(id_manager::g_mutex);
+			id_manager::type_writer_lock lock(get_type<T>());
 
 			auto& pair = g_vec[get_type<T>()];
 
@@ -754,7 +806,7 @@ public:
 	{
 		std::shared_ptr<T> ptr;
 		{
-			writer_lock lock(id_manager::g_mutex);
+			id_manager::type_writer_lock lock(get_type<T>());
 
 			auto& pair = g_vec[get_type<T>()];
 
@@ -786,7 +838,7 @@ public:
 		std::shared_ptr<T> ptr;
 		std::shared_ptr<void> old;
 		{
-			writer_lock lock(id_manager::g_mutex);
+			id_manager::type_writer_lock lock(get_type<T>());
 
 			auto& pair = g_vec[get_type<T>()];
 
@@ -820,7 +872,7 @@ public:
 	{
 		std::shared_ptr<T> ptr;
 		{
-			writer_lock lock(id_manager::g_mutex);
+			id_manager::type_writer_lock lock(get_type<T>());
 
 			auto& pair = g_vec[get_type<T>()];
 
@@ -852,7 +904,7 @@ public:
 	template <typename T>
 	static inline T* check()
 	{
-		reader_lock lock(id_manager::g_mutex);
+		reader_lock lock(id_manager::get_type_mutex(get_type<T>()));
 
 		return check_unlocked<T>();
 	}
@@ -861,7 +913,7 @@ public:
 	template <typename T>
 	static inline std::shared_ptr<T> get()
 	{
-		reader_lock lock(id_manager::g_mutex);
+		reader_lock lock(id_manager::get_type_mutex(get_type<T>()));
 
 		auto& ptr = g_vec[get_type<T>()].second;
 
@@ -874,7 +926,7 @@ public:
 	{
 		std::shared_ptr<void> ptr;
 		{
-			writer_lock lock(id_manager::g_mutex);
+			id_manager::type_writer_lock lock(get_type<T>());
 			ptr = std::move(g_vec[get_type<T>()].second);
 		}
 
@@ -892,7 +944,7 @@ public:
 	{
 		std::shared_ptr<void> ptr;
 		{
-			writer_lock lock(id_manager::g_mutex);
+			id_manager::type_writer_lock lock(get_type<T>());
 			ptr = std::move(g_vec[get_type<T>()].second);
 		}
 
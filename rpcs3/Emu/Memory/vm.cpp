@@ -3,6 +3,7 @@
 #include "Emu/System.h"
 #include "Utilities/mutex.h"
 #include "Utilities/cond.h"
+#include "Utilities/sync.h"
 #include "Utilities/Thread.h"
 #include "Utilities/VirtualMemory.h"
 #include "Emu/CPU/CPUThread.h"
@@ -54,21 +55,87 @@ namespace vm
 	// Memory mutex acknowledgement
 	thread_local atomic_t<cpu_thread*>* g_tls_locked = nullptr;
 
+	// Memory mutex: passive lock slot (one per thread, padded to avoid false sharing)
+	struct alignas(64) lock_slot
+	{
+		atomic_t<cpu_thread*> lock{nullptr}; // Registered reader
+		atomic_t<u32> owned{0}; // Assigned to a thread
+	};
+
+	// Block of passive lock slots (blocks are appended as the number of threads grows, never freed)
+	struct lock_block
+	{
+		std::array<lock_slot, 64> slots;
+		atomic_t<lock_block*> next{nullptr};
+	};
+
 	// Memory mutex: passive locks
-	std::array<atomic_t<cpu_thread*>, 32> g_locks;
+	lock_block g_locks;
 
-	static void _register_lock(cpu_thread* _cpu)
+	// Call func for every slot in every allocated block
+	template <typename F>
+	static void _for_each_slot(F&& func)
 	{
-		for (u32 i = 0;; i = (i + 1) % g_locks.size())
+		for (lock_block* block = &g_locks; block; block = block->next)
 		{
-			if (!g_locks[i] && g_locks[i].compare_and_swap_test(nullptr, _cpu))
+			for (auto& slot : block->slots)
 			{
-				g_tls_locked = g_locks.data() + i;
-				return;
+				func(slot);
 			}
 		}
 	}
 
+	static lock_slot* _alloc_slot()
+	{
+		for (lock_block* block = &g_locks;; block = block->next)
+		{
+			for (auto& slot : block->slots)
+			{
+				if (!slot.owned && slot.owned.compare_and_swap_test(0, 1))
+				{
+					return &slot;
+				}
+			}
+
+			if (!block->next)
+			{
+				// All slots are taken: append a new block (lost race is harmless)
+				const auto _new = new lock_block;
+
+				if (!block->next.compare_and_swap_test(nullptr, _new))
+				{
+					delete _new;
+				}
+			}
+		}
+	}
+
+	// Passive lock slot of the current thread (released on thread exit)
+	static thread_local struct tls_slot_holder
+	{
+		lock_slot* slot = nullptr;
+
+		~tls_slot_holder()
+		{
+			if (slot)
+			{
+				slot->lock = nullptr;
+				slot->owned = 0;
+			}
+		}
+	} g_tls_slot;
+
+	static void _register_lock(cpu_thread* _cpu)
+	{
+		if (UNLIKELY(!g_tls_slot.slot))
+		{
+			g_tls_slot.slot = _alloc_slot();
+		}
+
+		g_tls_slot.slot->lock = _cpu;
+		g_tls_locked = &g_tls_slot.slot->lock;
+	}
+
 	bool passive_lock(cpu_thread& cpu, bool wait)
 	{
 		if (UNLIKELY(g_tls_locked && *g_tls_locked == &cpu))
@@ -129,14 +196,13 @@ namespace vm
 			g_tls_locked = nullptr;
 		}
 
-		for (u32 i = 0; i < g_locks.size(); i++)
+		_for_each_slot([&](lock_slot& slot)
 		{
-			if (g_locks[i] == &cpu)
+			if (slot.lock == &cpu)
 			{
-				g_locks[i].compare_and_swap_test(&cpu, nullptr);
-				return;
+				slot.lock.compare_and_swap_test(&cpu, nullptr);
 			}
-		}
+		});
 	}
 
 	void temporary_unlock(cpu_thread& cpu) noexcept
@@ -196,17 +262,17 @@ namespace vm
 
 		if (full)
 		{
-			for (auto& lock : g_locks)
+			_for_each_slot([](lock_slot& slot)
 			{
-				if (cpu_thread* ptr = lock)
+				if (cpu_thread* ptr = slot.lock)
 				{
 					ptr->state.test_and_set(cpu_flag::memory);
 				}
-			}
+			});
 
-			for (auto& lock : g_locks)
+			_for_each_slot([](lock_slot& slot)
 			{
-				while (cpu_thread* ptr = lock)
+				while (cpu_thread* ptr = slot.lock)
 				{
 					if (test(ptr->state, cpu_flag::dbg_global_stop + cpu_flag::exit))
 					{
@@ -215,7 +281,7 @@ namespace vm
 
 					busy_wait();
 				}
-			}
+			});
 		}
 
 		if (cpu)
@@ -233,6 +299,35 @@ namespace vm
 		}
 	}
 
+	reservation_waiter g_reservation_waiters[4096]{};
+
+	void reservation_wake_internal(reservation_waiter& slot)
+	{
+		slot.signal++;
+		futex(reinterpret_cast<int*>(&slot.signal.raw()), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+	}
+
+	void reservation_wait(u32 addr, u64 rtime, u64 usec_timeout)
+	{
+		auto& slot = reservation_wait_slot(addr);
+
+		const u32 signal = slot.signal;
+
+		// Register before checking the stamp, so reservation_update can't miss the waiter
+		slot.waiters++;
+
+		if (reservation_acquire(addr, 128) == rtime)
+		{
+			timespec timeout;
+			timeout.tv_sec  = usec_timeout / 1000000;
+			timeout.tv_nsec = (usec_timeout % 1000000) * 1000;
+
+			futex(reinterpret_cast<int*>(&slot.signal.raw()), FUTEX_WAIT_PRIVATE, signal, &timeout, nullptr, 0);
+		}
+
+		slot.waiters--;
+	}
+
 	void reservation_lock_internal(atomic_t<u64>& res)
 	{
 		for (u64 i = 0;; i++)
@@ -420,6 +515,144 @@ namespace vm
 		return true;
 	}
 
+	// Compare pattern at specified position
+	static bool search_match(const u8* data, const u8* pattern, const u8* mask, u32 len)
+	{
+		if (!mask)
+		{
+			return std::memcmp(data, pattern, len) == 0;
+		}
+
+		for (u32 i = 0; i < len; i++)
+		{
+			if ((data[i] ^ pattern[i]) & mask[i])
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	// Search in contiguous readable memory
+	static void search_range(u32 addr, u32 size, const u8* pattern, const u8* mask, u32 len, u32 max_count, std::vector<u32>& out)
+	{
+		if (size < len)
+		{
+			return;
+		}
+
+		const u8* const data = g_base_addr + addr;
+
+		// Last possible match position
+		const u32 last = size - len;
+
+		// Select first and last fully compared bytes as a filter
+		u32 first_byte = len, last_byte = 0;
+
+		for (u32 i = 0; i < len; i++)
+		{
+			if (!mask || mask[i] == 0xff)
+			{
+				first_byte = std::min(first_byte, i);
+				last_byte = i;
+			}
+		}
+
+		u32 pos = 0;
+
+		if (first_byte < len)
+		{
+			const __m128i v0 = _mm_set1_epi8(pattern[first_byte]);
+			const __m128i v1 = _mm_set1_epi8(pattern[last_byte]);
+
+			// Test 16 positions at once
+			for (; last >= 15 && pos <= last - 15; pos += 16)
+			{
+				const __m128i c0 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos + first_byte)), v0);
+				const __m128i c1 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos + last_byte)), v1);
+
+				for (u32 bits = _mm_movemask_epi8(_mm_and_si128(c0, c1)); bits; bits &= bits - 1)
+				{
+					const u32 found = pos + cnttz32(bits, true);
+
+					if (search_match(data + found, pattern, mask, len))
+					{
+						out.push_back(addr + found);
+
+						if (out.size() >= max_count)
+						{
+							return;
+						}
+					}
+				}
+			}
+		}
+
+		// Remaining positions (or patterns without fully compared bytes)
+		for (; pos <= last; pos++)
+		{
+			if (search_match(data + pos, pattern, mask, len))
+			{
+				out.push_back(addr + pos);
+
+				if (out.size() >= max_count)
+				{
+					return;
+				}
+			}
+		}
+	}
+
+	std::vector<u32> search(u32 addr, u32 size, const std::vector<u8>& pattern, const std::vector<u8>& mask, u32 max_count)
+	{
+		std::vector<u32> result;
+
+		if (pattern.empty() || (!mask.empty() && mask.size() != pattern.size()) || !max_count)
+		{
+			return result;
+		}
+
+		const u8* const _mask = mask.empty() ? nullptr : mask.data();
+		const u32 len = ::size32(pattern);
+
+		// Prevent deallocation while scanning
+		vm::reader_lock lock;
+
+		const u64 end = u64{addr} + size;
+
+		for (u64 page = addr / 4096 * 4096; page < end;)
+		{
+			if ((g_pages[page / 4096].flags & (page_allocated | page_readable)) != (page_allocated | page_readable))
+			{
+				page += 4096;
+				continue;
+			}
+
+			// Scan the whole run of readable pages, so matches crossing page boundaries are found
+			u64 run_end = page + 4096;
+
+			while (run_end < end && (g_pages[run_end / 4096].flags & (page_allocated | page_readable)) == (page_allocated | page_readable))
+			{
+				run_end += 4096;
+			}
+
+			const u32 from = static_cast<u32>(std::max<u64>(page, addr));
+			const u32 run_size = static_cast<u32>(std::min<u64>(run_end, end) - from);
+
+			search_range(from, run_size, pattern.data(), _mask, len, max_count, result);
+
+			if (result.size() >= max_count)
+			{
+				break;
+			}
+
+			page = run_end;
+		}
+
+		return result;
+	}
+
 	u32 alloc(u32 size, memory_location_t location, u32 align)
 	{
 		const auto block = get(location);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <map>
+#include <vector>
 #include <functional>
 #include <memory>
 #include "Utilities/VirtualMemory.h"
@@ -92,11 +93,42 @@ namespace vm
 		return reinterpret_cast<atomic_t<u64>*>(g_reservations)[addr / 128];
 	}
 
+	// Reservation wait slot (hashed by reservation line)
+	struct reservation_waiter
+	{
+		atomic_t<u32> waiters{0};
+		atomic_t<u32> signal{0}; // Futex word
+	};
+
+	extern reservation_waiter g_reservation_waiters[4096];
+
+	inline reservation_waiter& reservation_wait_slot(u32 addr)
+	{
+		return g_reservation_waiters[addr / 128 % 4096];
+	}
+
+	void reservation_wake_internal(reservation_waiter&);
+
+	// Wake threads waiting for the reservation line to change
+	inline void reservation_wake(u32 addr)
+	{
+		auto& slot = reservation_wait_slot(addr);
+
+		if (UNLIKELY(slot.waiters))
+		{
+			reservation_wake_internal(slot);
+		}
+	}
+
+	// Wait until the reservation stamp differs from rtime (returns on timeout, notification or spuriously)
+	void reservation_wait(u32 addr, u64 rtime, u64 usec_timeout);
+
 	// Update reservation status
 	inline void reservation_update(u32 addr, u32 size, bool lsb = false)
 	{
 		// Update reservation info with new timestamp
 		reservation_acquire(addr, size) = (__rdtsc() << 1) | u64{lsb};
+		reservation_wake(addr);
 	}
 
 	// Get reservation sync variable
@@ -125,6 +157,9 @@ namespace vm
 	// Check flags for specified memory range (unsafe)
 	bool check_addr(u32 addr, u32 size = 1, u8 flags = page_allocated);
 
+	// Find byte pattern in readable pages of specified range, return found addresses (mask: bits to compare, empty for exact match)
+	std::vector<u32> search(u32 addr, u32 size, const std::vector<u8>& pattern, const std::vector<u8>& mask = {}, u32 max_count = UINT32_MAX);
+
 	// Search and map memory in specified memory location (min alignment is 0x10000)
 	u32 alloc(u32 size, memory_location_t location, u32 align = 0x10000);
 
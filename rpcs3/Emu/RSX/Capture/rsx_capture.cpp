@@ -8,6 +8,10 @@
 #include "Emu/Memory/Memory.h"
 
 #include "xxhash.h"
+#include <zlib.h>
+
+#include <sstream>
+#include <cereal/archives/binary.hpp>
 
 namespace rsx
 {
@@ -36,6 +40,176 @@ namespace rsx
 			}
 		}
 
+		// Compress chunks of block data of approximately this size
+		constexpr std::size_t capture_chunk_size = 4 * 1024 * 1024;
+
+		// Process replay commands in batches of this size
+		constexpr std::size_t capture_command_batch = 8192;
+
+		struct capture_file
+		{
+			fs::file file;
+
+			// Final path (the file is written under a temporary name until the capture is complete)
+			std::string path;
+
+			// Set on the first write error (nothing else is written)
+			bool failed = false;
+
+			// Uncompressed data records waiting for compression
+			std::string pending;
+
+			// Written data hash -> secondary hash (collision check without keeping the data)
+			std::unordered_map<u64, u64> written;
+		};
+
+		static capture_file s_capture;
+
+		static bool write_chunk(capture_chunk_type type, const std::string& data)
+		{
+			if (s_capture.failed)
+			{
+				return false;
+			}
+
+			uLongf csize = compressBound(::narrow<uLong>(data.size(), HERE));
+			std::vector<u8> buffer(csize);
+
+			if (compress2(buffer.data(), &csize, reinterpret_cast<const Bytef*>(data.data()), ::narrow<uLong>(data.size(), HERE), Z_BEST_SPEED) != Z_OK)
+			{
+				LOG_ERROR(RSX, "capture: failed to compress chunk (size=0x%x)", data.size());
+				s_capture.failed = true;
+				return false;
+			}
+
+			const capture_chunk_header header{type, ::narrow<u32>(csize, HERE), ::size32(data)};
+
+			if (s_capture.file.write(&header, sizeof(header)) != sizeof(header) || s_capture.file.write(buffer.data(), csize) != csize)
+			{
+				LOG_ERROR(RSX, "capture: failed to write %s.tmp (%s)", s_capture.path, fs::g_tls_error);
+				s_capture.failed = true;
+				return false;
+			}
+
+			return true;
+		}
+
+		static void write_block_data(u64 hash, const std::vector<u8>& data)
+		{
+			const auto found = s_capture.written.emplace(hash, XXH64(data.data(), data.size(), 1));
+
+			if (!found.second)
+			{
+				if (found.first->second != XXH64(data.data(), data.size(), 1))
+					fmt::throw_exception("Memory map hash collision detected...cant capture");
+
+				// Already written
+				return;
+			}
+
+			const u32 size = ::size32(data);
+			s_capture.pending.append(reinterpret_cast<const char*>(&hash), sizeof(hash));
+			s_capture.pending.append(reinterpret_cast<const char*>(&size), sizeof(size));
+			s_capture.pending.append(reinterpret_cast<const char*>(data.data()), size);
+
+			if (s_capture.pending.size() >= capture_chunk_size)
+			{
+				// Errors are reported by end_capture_file()
+				write_chunk(capture_chunk_type::data, s_capture.pending);
+				s_capture.pending.clear();
+			}
+		}
+
+		bool begin_capture_file(const std::string& path)
+		{
+			// Keep the previous capture until the new one is complete
+			if (!s_capture.file.open(path + ".tmp", fs::rewrite))
+			{
+				LOG_ERROR(RSX, "capture: failed to create %s.tmp (%s)", path, fs::g_tls_error);
+				return false;
+			}
+
+			s_capture.path = path;
+			s_capture.failed = false;
+			s_capture.pending.clear();
+			s_capture.written.clear();
+
+			const u32 header[2]{FRAME_CAPTURE_MAGIC, FRAME_CAPTURE_VERSION};
+
+			if (s_capture.file.write(header, sizeof(header)) != sizeof(header))
+			{
+				LOG_ERROR(RSX, "capture: failed to write %s.tmp (%s)", path, fs::g_tls_error);
+				s_capture.failed = true;
+			}
+
+			return true;
+		}
+
+		void flush_capture_commands(bool force)
+		{
+			auto& commands = frame_capture.replay_commands;
+
+			if (commands.empty() || (!force && commands.size() < capture_command_batch))
+			{
+				return;
+			}
+
+			std::ostringstream os;
+			{
+				cereal::BinaryOutputArchive archive(os);
+				archive(commands);
+			}
+
+			// Errors are reported by end_capture_file()
+			write_chunk(capture_chunk_type::commands, os.str());
+			commands.clear();
+		}
+
+		bool end_capture_file()
+		{
+			bool result = true;
+
+			if (!s_capture.pending.empty())
+			{
+				result = write_chunk(capture_chunk_type::data, s_capture.pending) && result;
+				s_capture.pending.clear();
+			}
+
+			flush_capture_commands(true);
+
+			// Remaining state (block data and commands have been written)
+			std::ostringstream os;
+			{
+				cereal::BinaryOutputArchive archive(os);
+				archive(frame_capture);
+			}
+
+			result = write_chunk(capture_chunk_type::state, os.str()) && result;
+
+			// Any failed write makes the capture incomplete
+			result = result && !s_capture.failed;
+
+			s_capture.file.close();
+			s_capture.written.clear();
+
+			const std::string tmp_path = s_capture.path + ".tmp";
+
+			if (!result)
+			{
+				fs::remove_file(tmp_path);
+				return false;
+			}
+
+			if (!fs::rename(tmp_path, s_capture.path, true))
+			{
+				LOG_ERROR(RSX, "capture: failed to rename %s (%s)", tmp_path, fs::g_tls_error);
+				fs::remove_file(tmp_path);
+				return false;
+			}
+
+			return true;
+		}
+
 		void insert_mem_block_in_map(std::unordered_set<u64>& mem_changes, frame_capture_data::memory_block&& block, frame_capture_data::memory_block_data&& data)
 		{
 			u64 data_hash = 0;
@@ -49,15 +223,8 @@ namespace rsx
 				block.size       = data.data.size();
 				block.data_state = data_hash;
 
-				auto it = frame_capture.memory_data_map.find(data_hash);
-				if (it != frame_capture.memory_data_map.end())
-				{
-					if (it->second.data != data.data)
-						// screw this
-						fmt::throw_exception("Memory map hash collision detected...cant capture");
-				}
-				else
-					frame_capture.memory_data_map.insert(std::make_pair(data_hash, std::move(data)));
+				// Data is written to the capture file immediately (only once per hash)
+				write_block_data(data_hash, data.data);
 			}
 
 			u64 block_hash = XXH64(&block, sizeof(frame_capture_data::memory_block), 0);
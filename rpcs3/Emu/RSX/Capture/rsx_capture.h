@@ -13,5 +13,10 @@ namespace rsx
 		void capture_surface_state(thread* rsx, frame_capture_data::replay_command& replay_command);
 		void capture_get_report(thread* rsx, frame_capture_data::replay_command& replay_command, u32 arg);
 		void capture_inline_transfer(thread* rsx, frame_capture_data::replay_command& replay_command, u32 idx, u32 arg);
+
+		// Streaming capture file: replay commands and memory block data are written while capturing
+		bool begin_capture_file(const std::string& path);
+		void flush_capture_commands(bool force = false);
+		bool end_capture_file();
 	}
 }
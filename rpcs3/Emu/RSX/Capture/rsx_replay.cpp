@@ -5,11 +5,147 @@
 #include "Emu/Cell/lv2/sys_rsx.h"
 #include "Emu/Memory/Memory.h"
 #include "Emu/RSX/GSRender.h"
+#include "Emu/Benchmark.h"
 
 #include <map>
+#include <fstream>
+#include <sstream>
+#include <cereal/archives/binary.hpp>
+
+#include <zlib.h>
 
 namespace rsx
 {
+	std::unique_ptr<frame_capture_data> load_frame_capture(const std::string& path)
+	{
+		fs::file file(path);
+
+		if (!file)
+		{
+			LOG_ERROR(LOADER, "Failed to open rsx capture file: %s (%s)", path, fs::g_tls_error);
+			return nullptr;
+		}
+
+		u32 magic = 0, version = 0;
+
+		if (!file.read(magic) || !file.read(version) || magic != FRAME_CAPTURE_MAGIC)
+		{
+			LOG_ERROR(LOADER, "Invalid rsx capture file!");
+			return nullptr;
+		}
+
+		auto frame = std::make_unique<frame_capture_data>();
+
+		if (version == FRAME_CAPTURE_VERSION_LEGACY)
+		{
+			// Single archive containing everything
+			file.close();
+
+			std::fstream f(path, std::ios::in | std::ios::binary);
+			cereal::BinaryInputArchive archive(f);
+			archive(*frame);
+			return frame;
+		}
+
+		if (version != FRAME_CAPTURE_VERSION)
+		{
+			LOG_ERROR(LOADER, "Rsx capture file version not supported! Expected %d, found %d", FRAME_CAPTURE_VERSION, version);
+			return nullptr;
+		}
+
+		// Read chunks one by one (only one chunk is kept in compressed and uncompressed form, decoded contents are accumulated)
+		std::vector<frame_capture_data::replay_command> commands;
+		std::vector<u8> cdata;
+		std::string udata;
+		bool has_state = false;
+
+		for (capture_chunk_header header; file.read(header);)
+		{
+			cdata.resize(header.csize);
+			udata.resize(header.usize);
+
+			uLongf usize = header.usize;
+
+			if (!file.read(cdata) || uncompress(reinterpret_cast<Bytef*>(&udata.front()), &usize, cdata.data(), header.csize) != Z_OK || usize != header.usize)
+			{
+				LOG_ERROR(LOADER, "Rsx capture file is corrupted (chunk at 0x%x)", file.pos() - header.csize - sizeof(header));
+				return nullptr;
+			}
+
+			switch (header.type)
+			{
+			case capture_chunk_type::data:
+			{
+				for (std::size_t pos = 0; pos < udata.size();)
+				{
+					u64 hash;
+					u32 size;
+
+					if (udata.size() - pos < sizeof(hash) + sizeof(size))
+					{
+						LOG_ERROR(LOADER, "Rsx capture file is corrupted (data record)");
+						return nullptr;
+					}
+
+					std::memcpy(&hash, &udata[pos], sizeof(hash));
+					std::memcpy(&size, &udata[pos + sizeof(hash)], sizeof(size));
+					pos += sizeof(hash) + sizeof(size);
+
+					if (udata.size() - pos < size)
+					{
+						LOG_ERROR(LOADER, "Rsx capture file is corrupted (data record)");
+						return nullptr;
+					}
+
+					auto& block = frame->memory_data_map[hash].data;
+					block.assign(&udata[pos], &udata[pos] + size);
+					pos += size;
+				}
+
+				break;
+			}
+			case capture_chunk_type::commands:
+			{
+				std::istringstream is(udata);
+				cereal::BinaryInputArchive archive(is);
+				archive(commands);
+
+				std::move(commands.begin(), commands.end(), std::back_inserter(frame->replay_commands));
+				commands.clear();
+				break;
+			}
+			case capture_chunk_type::state:
+			{
+				// Keep the data and commands read so far
+				auto data_map = std::move(frame->memory_data_map);
+				auto replay_commands = std::move(frame->replay_commands);
+
+				std::istringstream is(udata);
+				cereal::BinaryInputArchive archive(is);
+				archive(*frame);
+
+				frame->memory_data_map = std::move(data_map);
+				frame->replay_commands = std::move(replay_commands);
+				has_state = true;
+				break;
+			}
+			default:
+			{
+				LOG_WARNING(LOADER, "Rsx capture file: unknown chunk type 0x%x skipped", static_cast<u32>(header.type));
+				break;
+			}
+			}
+		}
+
+		if (!has_state)
+		{
+			LOG_ERROR(LOADER, "Rsx capture file is incomplete!");
+			return nullptr;
+		}
+
+		return frame;
+	}
+
 	be_t<u32> rsx_replay_thread::allocate_context()
 	{
 		const u32 contextAddr = vm::alloc(sizeof(rsx_context), vm::main);
@@ -283,12 +419,36 @@ namespace rsx
 				fmt::throw_exception("rsx io map failed for block");
 		}
 
-		while (!Emu.IsStopped())
+		auto renderer = fxm::get<GSRender>();
+
+		// Batch mode: measure frontend in detail and don't throttle
+		renderer->performance_counters.detailed = loops != 0;
+
+		for (u32 iteration = 0; !Emu.IsStopped(); iteration++)
 		{
+			if (loops && iteration == loops)
+			{
+				LOG_SUCCESS(RSX, "Capture Replay: %u iterations done", loops);
+
+				// Deferred, so the benchmark started after boot is always found
+				Emu.CallAfter([]()
+				{
+					if (const auto bench = fxm::get<benchmark_thread>())
+					{
+						bench->finish();
+						return;
+					}
+
+					Emu.Stop();
+					Emu.GetCallbacks().exit();
+				});
+
+				break;
+			}
+
 			// start up fifo buffer by dumping the put ptr to first stop
 			sys_rsx_context_attribute(context_id, 0x001, fifo_start_addr, fifo_stops[0], 0, 0);
 
-			auto renderer = fxm::get<GSRender>();
 			size_t stopIdx = 0;
 			for (const auto& replay_cmd : frame->replay_commands)
 			{
@@ -332,7 +492,8 @@ namespace rsx
 			}
 
 			// random pause to not destroy gpu
-			std::this_thread::sleep_for(10ms);
+			if (!loops)
+				std::this_thread::sleep_for(10ms);
 		}
 
 		state += cpu_flag::exit;
@@ -15,7 +15,24 @@
 namespace rsx
 {
 	constexpr u32 FRAME_CAPTURE_MAGIC = 0x52524300; // ascii 'RRC/0'
-	constexpr u32 FRAME_CAPTURE_VERSION = 0x1;
+	constexpr u32 FRAME_CAPTURE_VERSION = 0x2;
+	constexpr u32 FRAME_CAPTURE_VERSION_LEGACY = 0x1; // Single cereal archive
+
+	// Chunked capture format: magic and version followed by zlib-compressed chunks
+	// Memory block data is stored once per unique content hash, the last chunk contains the remaining state
+	enum class capture_chunk_type : u32
+	{
+		data = 1,     // Memory block data records (u64 hash, u32 size, data)
+		commands = 2, // Replay commands (appended in order)
+		state = 3,    // frame_capture_data without memory block data and replay commands
+	};
+
+	struct capture_chunk_header
+	{
+		capture_chunk_type type;
+		u32 csize; // Compressed size
+		u32 usize; // Uncompressed size
+	};
 	struct frame_capture_data
 	{
 
@@ -199,10 +216,17 @@ namespace rsx
 			version = FRAME_CAPTURE_VERSION;
 			tile_map.clear();
 			memory_map.clear();
+			memory_data_map.clear();
+			display_buffers_map.clear();
 			replay_commands.clear();
 		}
 	};
 
+	// Load capture file (nullptr on error)
+	// The whole capture (all commands and unique memory blocks) is kept in memory: the replay needs every command
+	// to build the FIFO and the memory block descriptors are only stored in the last chunk
+	std::unique_ptr<frame_capture_data> load_frame_capture(const std::string& path);
+
 
 	class rsx_replay_thread : public ppu_thread
 	{
@@ -226,10 +250,11 @@ namespace rsx
 
 		current_state cs;
 		std::unique_ptr<frame_capture_data> frame;
+		const u32 loops; // Number of replays in batch mode (0 = replay until stopped)
 
 	public:
-		rsx_replay_thread(std::unique_ptr<frame_capture_data>&& frame_data)
-			: ppu_thread("Rsx Capture Replay Thread"), frame(std::move(frame_data)) {};
+		rsx_replay_thread(std::unique_ptr<frame_capture_data>&& frame_data, u32 loops = 0)
+			: ppu_thread("Rsx Capture Replay Thread"), frame(std::move(frame_data)), loops(loops) {};
 
 		virtual void cpu_task() override;
 	private:
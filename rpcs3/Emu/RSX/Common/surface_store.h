@@ -2,7 +2,8 @@
 
 #include "Utilities/GSL.h"
 #include "../GCM.h"
-#include <list>
+#include <map>
+#include <unordered_map>
 
 namespace rsx
 {
@@ -147,21 +148,174 @@ namespace rsx
 		using surface_subresource = surface_subresource_storage<surface_type>;
 		using surface_overlap_info = surface_overlap_info_t<surface_type>;
 
-		std::unordered_map<u32, surface_storage_type> m_render_targets_storage = {};
-		std::unordered_map<u32, surface_storage_type> m_depth_stencil_storage = {};
+		// Stored surfaces sorted by base address (allows range queries)
+		std::map<u32, surface_storage_type> m_render_targets_storage = {};
+		std::map<u32, surface_storage_type> m_depth_stencil_storage = {};
+
+		// Upper bound of the memory range covered by a single color/depth surface (indexed by is_depth)
+		std::array<u32, 2> m_max_surface_range = {};
+		std::array<bool, 2> m_surface_range_dirty = {};
+
+		struct surface_info
+		{
+			u32 address;
+			u64 pool_key;
+		};
+
+		// Base address and pool bucket of every owned surface
+		std::unordered_map<surface_type, surface_info> m_surface_info;
+
+		// Invalidated surfaces available for reuse, bucketed by format and size
+		std::unordered_map<u64, std::vector<surface_storage_type>> m_invalidated_pool;
 
 	public:
 		std::array<std::tuple<u32, surface_type>, 4> m_bound_render_targets = {};
 		std::tuple<u32, surface_type> m_bound_depth_stencil = {};
 
-		std::list<surface_storage_type> invalidated_resources;
 		u64 cache_tag = 0ull;
 		u64 write_tag = 0ull;
 
 		surface_store() = default;
 		~surface_store() = default;
 		surface_store(const surface_store&) = delete;
+
+		/**
+		 * Remove invalidated surfaces for which the predicate returns true (predicate may take ownership of the storage)
+		 */
+		template <typename F>
+		void remove_invalidated_if(F&& pred)
+		{
+			for (auto It = m_invalidated_pool.begin(); It != m_invalidated_pool.end();)
+			{
+				auto &bucket = It->second;
+
+				for (size_t i = 0; i < bucket.size();)
+				{
+					const auto surface = Traits::get(bucket[i]);
+
+					if (!pred(bucket[i]))
+					{
+						i++;
+						continue;
+					}
+
+					m_surface_info.erase(surface);
+
+					if (i != bucket.size() - 1)
+						bucket[i] = std::move(bucket.back());
+
+					bucket.pop_back();
+				}
+
+				if (bucket.empty())
+					It = m_invalidated_pool.erase(It);
+				else
+					It++;
+			}
+		}
+
 	protected:
+		static u64 get_pool_key(bool is_depth, u32 format, size_t width, size_t height)
+		{
+			return (u64{ is_depth } << 63) | (u64{ format } << 32) | ((width & 0xffff) << 16) | (height & 0xffff);
+		}
+
+		u32 get_surface_range(surface_type surface) const
+		{
+			surface_format_info info;
+			Traits::get_surface_info(surface, &info);
+
+			// Doubled to account for the AA sample layout
+			return info.rsx_pitch * info.surface_height * 2;
+		}
+
+		/**
+		 * Returns the largest memory range covered by a single stored surface
+		 * Pitch of bound surfaces can still change, so they are always tested
+		 */
+		u32 get_max_surface_range(bool is_depth)
+		{
+			u32 &max_range = m_max_surface_range[is_depth];
+
+			if (m_surface_range_dirty[is_depth])
+			{
+				max_range = 0;
+
+				for (auto &tex_info : is_depth ? m_depth_stencil_storage : m_render_targets_storage)
+					max_range = std::max(max_range, get_surface_range(Traits::get(tex_info.second)));
+
+				m_surface_range_dirty[is_depth] = false;
+			}
+
+			if (is_depth)
+			{
+				if (auto ds = std::get<1>(m_bound_depth_stencil))
+					max_range = std::max(max_range, get_surface_range(ds));
+			}
+			else
+			{
+				for (auto &rtt : m_bound_render_targets)
+				{
+					if (auto surface = std::get<1>(rtt))
+						max_range = std::max(max_range, get_surface_range(surface));
+				}
+			}
+
+			return max_range;
+		}
+
+		void insert_surface(std::map<u32, surface_storage_type>& data, u32 address, u64 pool_key, surface_storage_type&& storage)
+		{
+			m_surface_info[Traits::get(storage)] = { address, pool_key };
+			data[address] = std::move(storage);
+		}
+
+		/**
+		 * Move stored surface to the invalidated pool
+		 */
+		void invalidate_surface(std::map<u32, surface_storage_type>& data, typename std::map<u32, surface_storage_type>::iterator It, bool is_depth)
+		{
+			Traits::notify_surface_invalidated(It->second);
+			m_invalidated_pool[m_surface_info[Traits::get(It->second)].pool_key].push_back(std::move(It->second));
+			data.erase(It);
+
+			m_surface_range_dirty[is_depth] = true;
+		}
+
+		/**
+		 * Take a surface with matching key from the invalidated pool, if any
+		 */
+		template <typename F>
+		bool take_invalidated_surface(u64 pool_key, surface_storage_type& result, F&& test)
+		{
+			const auto found = m_invalidated_pool.find(pool_key);
+
+			if (found == m_invalidated_pool.end())
+				return false;
+
+			auto &bucket = found->second;
+
+			for (auto &storage : bucket)
+			{
+				if (!test(storage))
+					continue;
+
+				result = std::move(storage);
+
+				if (&storage != &bucket.back())
+					storage = std::move(bucket.back());
+
+				bucket.pop_back();
+
+				if (bucket.empty())
+					m_invalidated_pool.erase(found);
+
+				return true;
+			}
+
+			return false;
+		}
+
 		/**
 		* If render target already exists at address, issue state change operation on cmdList.
 		* Otherwise create one with width, height, clearColor info.
@@ -176,7 +330,6 @@ namespace rsx
 		{
 			// TODO: Fix corner cases
 			// This doesn't take overlapping surface(s) into account.
-			surface_storage_type old_surface_storage;
 			surface_storage_type new_surface_storage;
 			surface_type old_surface = nullptr;
 			surface_type new_surface = nullptr;
@@ -186,10 +339,8 @@ namespace rsx
 			auto aliased_depth_surface = m_depth_stencil_storage.find(address);
 			if (aliased_depth_surface != m_depth_stencil_storage.end())
 			{
-				Traits::notify_surface_invalidated(aliased_depth_surface->second);
 				convert_surface = Traits::get(aliased_depth_surface->second);
-				invalidated_resources.push_back(std::move(aliased_depth_surface->second));
-				m_depth_stencil_storage.erase(aliased_depth_surface);
+				invalidate_surface(m_depth_stencil_storage, aliased_depth_surface, true);
 			}
 
 			auto It = m_render_targets_storage.find(address);
@@ -204,53 +355,37 @@ namespace rsx
 				}
 
 				old_surface = Traits::get(rtt);
-				old_surface_storage = std::move(rtt);
-				m_render_targets_storage.erase(address);
 			}
 
 			// Select source of original data if any
 			auto contents_to_copy = old_surface == nullptr ? convert_surface : old_surface;
 
 			// Search invalidated resources for a suitable surface
-			for (auto It = invalidated_resources.begin(); It != invalidated_resources.end(); It++)
-			{
-				auto &rtt = *It;
-				if (Traits::rtt_has_format_width_height(rtt, color_format, width, height, true))
+			const u64 pool_key = get_pool_key(false, (u32)color_format, width, height);
+			if (take_invalidated_surface(pool_key, new_surface_storage, [&](const surface_storage_type& rtt)
 				{
-					new_surface_storage = std::move(rtt);
-
-					if (old_surface)
-					{
-						//Exchange this surface with the invalidated one
-						Traits::notify_surface_invalidated(old_surface_storage);
-						rtt = std::move(old_surface_storage);
-					}
-					else
-						//rtt is now empty - erase it
-						invalidated_resources.erase(It);
-
-					new_surface = Traits::get(new_surface_storage);
-					Traits::invalidate_surface_contents(command_list, new_surface, contents_to_copy);
-					Traits::prepare_rtt_for_drawing(command_list, new_surface);
-					break;
-				}
+					return Traits::rtt_has_format_width_height(rtt, color_format, width, height, true);
+				}))
+			{
+				new_surface = Traits::get(new_surface_storage);
+				Traits::invalidate_surface_contents(command_list, new_surface, contents_to_copy);
+				Traits::prepare_rtt_for_drawing(command_list, new_surface);
 			}
 
-			if (old_surface != nullptr && new_surface == nullptr)
+			if (old_surface != nullptr)
 			{
 				//This was already determined to be invalid and is excluded from testing above
-				Traits::notify_surface_invalidated(old_surface_storage);
-				invalidated_resources.push_back(std::move(old_surface_storage));
+				invalidate_surface(m_render_targets_storage, It, false);
 			}
 
 			if (new_surface != nullptr)
 			{
 				//New surface was found among existing surfaces
-				m_render_targets_storage[address] = std::move(new_surface_storage);
+				insert_surface(m_render_targets_storage, address, pool_key, std::move(new_surface_storage));
 				return new_surface;
 			}
 
-			m_render_targets_storage[address] = Traits::create_new_surface(address, color_format, width, height, contents_to_copy, std::forward<Args>(extra_params)...);
+			insert_surface(m_render_targets_storage, address, pool_key, Traits::create_new_surface(address, color_format, width, height, contents_to_copy, std::forward<Args>(extra_params)...));
 			return Traits::get(m_render_targets_storage[address]);
 		}
 
@@ -261,7 +396,6 @@ namespace rsx
 			surface_depth_format depth_format, size_t width, size_t height,
 			Args&&... extra_params)
 		{
-			surface_storage_type old_surface_storage;
 			surface_storage_type new_surface_storage;
 			surface_type old_surface = nullptr;
 			surface_type new_surface = nullptr;
@@ -271,10 +405,8 @@ namespace rsx
 			auto aliased_rtt_surface = m_render_targets_storage.find(address);
 			if (aliased_rtt_surface != m_render_targets_storage.end())
 			{
-				Traits::notify_surface_invalidated(aliased_rtt_surface->second);
 				convert_surface = Traits::get(aliased_rtt_surface->second);
-				invalidated_resources.push_back(std::move(aliased_rtt_surface->second));
-				m_render_targets_storage.erase(aliased_rtt_surface);
+				invalidate_surface(m_render_targets_storage, aliased_rtt_surface, false);
 			}
 
 			auto It = m_depth_stencil_storage.find(address);
@@ -289,52 +421,37 @@ namespace rsx
 				}
 
 				old_surface = Traits::get(ds);
-				old_surface_storage = std::move(ds);
-				m_depth_stencil_storage.erase(address);
 			}
 
 			// Select source of original data if any
 			auto contents_to_copy = old_surface == nullptr ? convert_surface : old_surface;
 
 			//Search invalidated resources for a suitable surface
-			for (auto It = invalidated_resources.begin(); It != invalidated_resources.end(); It++)
-			{
-				auto &ds = *It;
-				if (Traits::ds_has_format_width_height(ds, depth_format, width, height, true))
+			const u64 pool_key = get_pool_key(true, (u32)depth_format, width, height);
+			if (take_invalidated_surface(pool_key, new_surface_storage, [&](const surface_storage_type& ds)
 				{
-					new_surface_storage = std::move(ds);
-
-					if (old_surface)
-					{
-						//Exchange this surface with the invalidated one
-						Traits::notify_surface_invalidated(old_surface_storage);
-						ds = std::move(old_surface_storage);
-					}
-					else
-						invalidated_resources.erase(It);
-
-					new_surface = Traits::get(new_surface_storage);
-					Traits::prepare_ds_for_drawing(command_list, new_surface);
-					Traits::invalidate_surface_contents(command_list, new_surface, contents_to_copy);
-					break;
-				}
+					return Traits::ds_has_format_width_height(ds, depth_format, width, height, true);
+				}))
+			{
+				new_surface = Traits::get(new_surface_storage);
+				Traits::prepare_ds_for_drawing(command_list, new_surface);
+				Traits::invalidate_surface_contents(command_list, new_surface, contents_to_copy);
 			}
 
-			if (old_surface != nullptr && new_surface == nullptr)
+			if (old_surface != nullptr)
 			{
 				//This was already determined to be invalid and is excluded from testing above
-				Traits::notify_surface_invalidated(old_surface_storage);
-				invalidated_resources.push_back(std::move(old_surface_storage));
+				invalidate_surface(m_depth_stencil_storage, It, true);
 			}
 
 			if (new_surface != nullptr)
 			{
 				//New surface was found among existing surfaces
-				m_depth_stencil_storage[address] = std::move(new_surface_storage);
+				insert_surface(m_depth_stencil_storage, address, pool_key, std::move(new_surface_storage));
 				return new_surface;
 			}
 
-			m_depth_stencil_storage[address] = Traits::create_new_surface(address, depth_format, width, height, contents_to_copy, std::forward<Args>(extra_params)...);
+			insert_surface(m_depth_stencil_storage, address, pool_key, Traits::create_new_surface(address, depth_format, width, height, contents_to_copy, std::forward<Args>(extra_params)...));
 			return Traits::get(m_depth_stencil_storage[address]);
 		}
 	public:
@@ -358,6 +475,10 @@ namespace rsx
 
 			cache_tag++;
 
+			// Pitch of the previous surfaces is final, include it in the range index before unbinding
+			get_max_surface_range(false);
+			get_max_surface_range(true);
+
 			// Make previous RTTs sampleable
 			for (std::tuple<u32, surface_type> &rtt : m_bound_render_targets)
 			{
@@ -558,41 +679,17 @@ namespace rsx
 		 */
 		void invalidate_single_surface(surface_type surface, bool depth)
 		{
-			if (!depth)
-			{
-				for (auto It = m_render_targets_storage.begin(); It != m_render_targets_storage.end(); It++)
-				{
-					const auto address = It->first;
-					const auto ref = Traits::get(It->second);
+			const auto found = m_surface_info.find(surface);
+			if (found == m_surface_info.end())
+				return;
 
-					if (surface == ref)
-					{
-						Traits::notify_surface_invalidated(It->second);
-						invalidated_resources.push_back(std::move(It->second));
-						m_render_targets_storage.erase(It);
+			auto &data = depth ? m_depth_stencil_storage : m_render_targets_storage;
+			auto It = data.find(found->second.address);
 
-						cache_tag++;
-						return;
-					}
-				}
-			}
-			else
+			if (It != data.end() && Traits::get(It->second) == surface)
 			{
-				for (auto It = m_depth_stencil_storage.begin(); It != m_depth_stencil_storage.end(); It++)
-				{
-					const auto address = It->first;
-					const auto ref = Traits::get(It->second);
-
-					if (surface == ref)
-					{
-						Traits::notify_surface_invalidated(It->second);
-						invalidated_resources.push_back(std::move(It->second));
-						m_depth_stencil_storage.erase(It);
-
-						cache_tag++;
-						return;
-					}
-				}
+				invalidate_surface(data, It, depth);
+				cache_tag++;
 			}
 		}
 
@@ -607,31 +704,13 @@ namespace rsx
 				return;
 			}
 
-			if (!depth)
-			{
-				auto It = m_render_targets_storage.find(addr);
-				if (It != m_render_targets_storage.end())
-				{
-					Traits::notify_surface_invalidated(It->second);
-					invalidated_resources.push_back(std::move(It->second));
-					m_render_targets_storage.erase(It);
+			auto &data = depth ? m_depth_stencil_storage : m_render_targets_storage;
+			auto It = data.find(addr);
 
-					cache_tag++;
-					return;
-				}
-			}
-			else
+			if (It != data.end())
 			{
-				auto It = m_depth_stencil_storage.find(addr);
-				if (It != m_depth_stencil_storage.end())
-				{
-					Traits::notify_surface_invalidated(It->second);
-					invalidated_resources.push_back(std::move(It->second));
-					m_depth_stencil_storage.erase(It);
-
-					cache_tag++;
-					return;
-				}
+				invalidate_surface(data, It, depth);
+				cache_tag++;
 			}
 		}
 
@@ -790,22 +869,28 @@ namespace rsx
 				return false;
 			};
 
-			surface_type surface = nullptr;
 			bool clipped = false;
 			u16  x_offset = 0;
 			u16  y_offset = 0;
 			u16  w;
 			u16  h;
 
-			if (!ignore_color_formats)
+			surface_subresource result = {};
+
+			// Visit surfaces starting at or below texaddr (closest first) while they can still overlap it
+			auto process_list_function = [&](std::map<u32, surface_storage_type>& data, bool is_depth)
 			{
-				for (auto &tex_info : m_render_targets_storage)
+				const u32 max_range = get_max_surface_range(is_depth);
+
+				for (auto It = data.upper_bound(texaddr); It != data.begin();)
 				{
-					const u32 this_address = std::get<0>(tex_info);
-					if (texaddr < this_address)
-						continue;
+					--It;
 
-					surface = std::get<1>(tex_info).get();
+					const u32 this_address = It->first;
+					if (this_address != texaddr && texaddr - this_address >= max_range)
+						break;
+
+					auto surface = Traits::get(It->second);
 					if (surface->get_rsx_pitch() != requested_pitch)
 						continue;
 
@@ -813,40 +898,27 @@ namespace rsx
 					{
 						if (!surface_overlaps_address_fast(surface, this_address, texaddr))
 							continue;
-						else
-							return{ this_address, surface, 0, 0, 0, 0, false, false, false };
+
+						result = { this_address, surface, 0, 0, 0, 0, false, is_depth, false };
+						return true;
 					}
 
 					if (test_surface(surface, this_address, x_offset, y_offset, w, h, clipped))
-						return{ this_address, surface, x_offset, y_offset, w, h, address_is_bound(this_address, false), false, clipped };
+					{
+						result = { this_address, surface, x_offset, y_offset, w, h, address_is_bound(this_address, is_depth), is_depth, clipped };
+						return true;
+					}
 				}
-			}
-
-			if (!ignore_depth_formats)
-			{
-				//Check depth surfaces for overlap
-				for (auto &tex_info : m_depth_stencil_storage)
-				{
-					const u32 this_address = std::get<0>(tex_info);
-					if (texaddr < this_address)
-						continue;
 
-					surface = std::get<1>(tex_info).get();
-					if (surface->get_rsx_pitch() != requested_pitch)
-						continue;
+				return false;
+			};
 
-					if (requested_width == 0 || requested_height == 0)
-					{
-						if (!surface_overlaps_address_fast(surface, this_address, texaddr))
-							continue;
-						else
-							return{ this_address, surface, 0, 0, 0, 0, false, true, false };
-					}
+			if (!ignore_color_formats && process_list_function(m_render_targets_storage, false))
+				return result;
 
-					if (test_surface(surface, this_address, x_offset, y_offset, w, h, clipped))
-						return{ this_address, surface, x_offset, y_offset, w, h, address_is_bound(this_address, true), true, clipped };
-				}
-			}
+			//Check depth surfaces for overlap
+			if (!ignore_depth_formats && process_list_function(m_depth_stencil_storage, true))
+				return result;
 
 			return{};
 		}
@@ -856,15 +928,16 @@ namespace rsx
 			std::vector<surface_overlap_info> result;
 			const u32 limit = texaddr + (required_pitch * required_height);
 
-			auto process_list_function = [&](std::unordered_map<u32, surface_storage_type>& data, bool is_depth)
+			auto process_list_function = [&](std::map<u32, surface_storage_type>& data, bool is_depth)
 			{
-				for (auto &tex_info : data)
-				{
-					auto this_address = std::get<0>(tex_info);
-					if (this_address >= limit)
-						continue;
+				// Only surfaces starting within max_range below texaddr can reach it
+				const u32 max_range = get_max_surface_range(is_depth);
+				const u32 range_start = texaddr > max_range ? texaddr - max_range : 0;
 
-					auto surface = std::get<1>(tex_info).get();
+				for (auto It = data.lower_bound(range_start); It != data.end() && It->first < limit; ++It)
+				{
+					const u32 this_address = It->first;
+					auto surface = Traits::get(It->second);
 					const auto pitch = surface->get_rsx_pitch();
 					if (pitch != required_pitch)
 						continue;
@@ -76,6 +76,8 @@ namespace rsx
 		u32 num_writes = 0;
 		std::deque<u32> read_history;
 
+		u64 last_used_frame = 0; // Used for LRU eviction
+
 		u64 cache_tag = 0;
 
 		memory_read_flags readback_behaviour = memory_read_flags::flush_once;
@@ -119,6 +121,11 @@ namespace rsx
 			num_writes++;
 		}
 
+		void mark_used(u64 frame)
+		{
+			last_used_frame = frame;
+		}
+
 		void reset_write_statistics()
 		{
 			if (read_history.size() == 16)
@@ -445,11 +452,13 @@ namespace rsx
 		const s32 m_max_zombie_objects = 64; //Limit on how many texture objects to keep around for reuse after they are invalidated
 		std::atomic<s32> m_unreleased_texture_objects = { 0 }; //Number of invalidated objects not yet freed from memory
 		std::atomic<u32> m_texture_memory_in_use = { 0 };
+		std::atomic<u32> m_num_evictions = { 0 }; //Sections freed to stay within the memory budget
 
 		//Other statistics
 		std::atomic<u32> m_num_flush_requests = { 0 };
 		std::atomic<u32> m_num_cache_misses = { 0 };
 		std::atomic<u32> m_num_cache_mispredictions = { 0 };
+		u64 m_frame_counter = 1;
 
 		/* Helpers */
 		virtual void free_texture_section(section_storage_type&) = 0;
@@ -1355,6 +1364,75 @@ namespace rsx
 			m_unreleased_texture_objects = 0;
 		}
 
+		/**
+		 * Frees least recently used sections until texture memory usage fits the configured budget
+		 * Only clean shader_read sections which were not used in the last frame are considered (they are reuploaded on demand)
+		 * Returns true if any section was evicted, in which case cached sampler descriptors must be refreshed
+		 */
+		bool enforce_memory_budget()
+		{
+			const u64 budget = g_cfg.video.texture_cache_budget * 0x100000ull;
+
+			if (!budget || m_texture_memory_in_use <= budget)
+			{
+				return false;
+			}
+
+			writer_lock lock(m_cache_mutex);
+
+			std::vector<std::pair<section_storage_type*, ranged_storage*>> candidates;
+
+			for (auto &address_range : m_cache)
+			{
+				for (auto &tex : address_range.second.data)
+				{
+					if (tex.is_dirty() || !tex.exists() || tex.is_flushable())
+						continue;
+
+					if (tex.get_context() != rsx::texture_upload_context::shader_read)
+						continue;
+
+					if (tex.last_used_frame + 1 >= m_frame_counter)
+						continue;
+
+					candidates.emplace_back(&tex, &address_range.second);
+				}
+			}
+
+			std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b)
+			{
+				return a.first->last_used_frame < b.first->last_used_frame;
+			});
+
+			u32 evicted = 0;
+
+			for (const auto &candidate : candidates)
+			{
+				if (m_texture_memory_in_use <= budget)
+					break;
+
+				auto &tex = *candidate.first;
+
+				if (tex.is_locked())
+					tex.unprotect();
+
+				tex.set_dirty(true);
+				candidate.second->remove_one();
+
+				free_texture_section(tex);
+				m_texture_memory_in_use -= tex.get_section_size();
+				evicted++;
+			}
+
+			if (evicted)
+			{
+				m_num_evictions += evicted;
+				update_cache_tag();
+			}
+
+			return evicted != 0;
+		}
+
 		image_view_type create_temporary_subresource(commandbuffer_type &cmd, deferred_subresource& desc)
 		{
 			const auto found = m_temporary_subresource_cache.equal_range(desc.base_address);
@@ -1810,6 +1888,7 @@ namespace rsx
 						if (cached_texture->get_sampler_status() != rsx::texture_sampler_status::status_ready)
 							set_up_remap_vector(*cached_texture, tex.decoded_remap());
 
+						cached_texture->mark_used(m_frame_counter);
 						return{ cached_texture->get_raw_view(), cached_texture->get_context(), cached_texture->is_depth_texture(), scale_x, scale_y, cached_texture->get_image_type() };
 					}
 				}
@@ -1882,9 +1961,11 @@ namespace rsx
 
 			//NOTE: SRGB correction is to be handled in the fragment shader; upload as linear RGB
 			m_texture_memory_in_use += (tex_pitch * tex_height);
-			return{ upload_image_from_cpu(cmd, texaddr, tex_width, tex_height, depth, tex.get_exact_mipmap_count(), tex_pitch, format,
-				texture_upload_context::shader_read, subresources_layout, extended_dimension, rsx::texture_colorspace::rgb_linear, is_swizzled, remap_vector)->get_raw_view(),
-				texture_upload_context::shader_read, is_depth_format, scale_x, scale_y, extended_dimension };
+			auto uploaded = upload_image_from_cpu(cmd, texaddr, tex_width, tex_height, depth, tex.get_exact_mipmap_count(), tex_pitch, format,
+				texture_upload_context::shader_read, subresources_layout, extended_dimension, rsx::texture_colorspace::rgb_linear, is_swizzled, remap_vector);
+
+			uploaded->mark_used(m_frame_counter);
+			return{ uploaded->get_raw_view(), texture_upload_context::shader_read, is_depth_format, scale_x, scale_y, extended_dimension };
 		}
 
 		template <typename surface_store_type, typename blitter_type, typename ...Args>
@@ -2431,6 +2512,7 @@ namespace rsx
 			m_num_flush_requests.store(0u);
 			m_num_cache_misses.store(0u);
 			m_num_cache_mispredictions.store(0u);
+			m_frame_counter++;
 		}
 
 		virtual const u32 get_unreleased_textures_count() const
@@ -2443,6 +2525,11 @@ namespace rsx
 			return m_texture_memory_in_use;
 		}
 
+		u32 get_num_evictions() const
+		{
+			return m_num_evictions;
+		}
+
 		virtual u32 get_num_flush_requests() const
 		{
 			return m_num_flush_requests;
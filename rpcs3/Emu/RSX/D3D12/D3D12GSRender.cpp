@@ -365,6 +365,7 @@ void D3D12GSRender::end()
 
 	std::chrono::time_point<steady_clock> vertex_index_duration_end = steady_clock::now();
 	m_timers.vertex_index_duration += std::chrono::duration_cast<std::chrono::microseconds>(vertex_index_duration_end - vertex_index_duration_start).count();
+	performance_counters.frontend.vertex_upload_time += std::chrono::duration_cast<std::chrono::nanoseconds>(vertex_index_duration_end - vertex_index_duration_start).count();
 
 	get_current_resource_storage().command_list->SetGraphicsRootSignature(m_shared_root_signature.Get());
 	get_current_resource_storage().command_list->OMSetStencilRef(rsx::method_registers.stencil_func_ref());
@@ -461,6 +462,7 @@ void D3D12GSRender::end()
 
 	std::chrono::time_point<steady_clock> texture_duration_end = steady_clock::now();
 	m_timers.texture_duration += std::chrono::duration_cast<std::chrono::microseconds>(texture_duration_end - texture_duration_start).count();
+	performance_counters.frontend.texture_time += std::chrono::duration_cast<std::chrono::nanoseconds>(texture_duration_end - texture_duration_start).count();
 	set_rtt_and_ds(get_current_resource_storage().command_list.Get());
 
 	int clip_w = rsx::method_registers.surface_clip_width();
@@ -682,8 +684,11 @@ void D3D12GSRender::flip(int buffer)
 	storage.fence_value++;
 
 	storage.in_use = true;
-	storage.dirty_textures.merge(m_rtts.invalidated_resources);
-	m_rtts.invalidated_resources.clear();
+	m_rtts.remove_invalidated_if([&](ComPtr<ID3D12Resource> &rtt)
+	{
+		storage.dirty_textures.push_back(std::move(rtt));
+		return true;
+	});
 
 	// Get the put pos - 1. This way after cleaning we can set the get ptr to
 	// this value, allowing heap to proceed even if we cleant before allocating
@@ -366,6 +366,7 @@ void GLGSRender::end()
 
 		std::chrono::time_point<steady_clock> textures_end = steady_clock::now();
 		m_textures_upload_time += (u32)std::chrono::duration_cast<std::chrono::microseconds>(textures_end - textures_start).count();
+		performance_counters.frontend.texture_time += std::chrono::duration_cast<std::chrono::nanoseconds>(textures_end - textures_start).count();
 	}
 
 	std::chrono::time_point<steady_clock> program_start = steady_clock::now();
@@ -892,6 +893,12 @@ void GLGSRender::on_exit()
 {
 	zcull_ctrl.release();
 
+	if (m_shaders_cache)
+	{
+		// Write pending pipelines
+		m_shaders_cache->flush();
+	}
+
 	m_prog_buffer.clear();
 
 	if (draw_fbo)
@@ -1520,7 +1527,7 @@ void GLGSRender::flip(int buffer)
 		const auto num_mispredict = m_gl_texture_cache.get_num_cache_mispredictions();
 		const auto cache_miss_ratio = (u32)ceil(m_gl_texture_cache.get_cache_miss_ratio() * 100);
 		m_text_printer.print_text(0, 126, m_frame->client_width(), m_frame->client_height(), "Unreleased textures: " + std::to_string(num_dirty_textures));
-		m_text_printer.print_text(0, 144, m_frame->client_width(), m_frame->client_height(), "Texture memory: " + std::to_string(texture_memory_size) + "M");
+		m_text_printer.print_text(0, 144, m_frame->client_width(), m_frame->client_height(), fmt::format("Texture memory: %dM (%d evicted)", texture_memory_size, m_gl_texture_cache.get_num_evictions()));
 		m_text_printer.print_text(0, 162, m_frame->client_width(), m_frame->client_height(), fmt::format("Flush requests: %d (%d%% hard faults, %d mispredictions)", num_flushes, cache_miss_ratio, num_mispredict));
 	}
 
@@ -1530,6 +1537,12 @@ void GLGSRender::flip(int buffer)
 	// Cleanup
 	m_gl_texture_cache.on_frame_end();
 
+	if (m_gl_texture_cache.enforce_memory_budget())
+		m_samplers_dirty.store(true);
+
+	performance_counters.texture_memory = m_gl_texture_cache.get_texture_memory_in_use();
+	performance_counters.texture_evictions = m_gl_texture_cache.get_num_evictions();
+
 	m_rtts.free_invalidated();
 	m_vertex_cache->purge();
 
@@ -309,7 +309,7 @@ struct gl_render_targets : public rsx::surface_store<gl_render_target_traits>
 {
 	void free_invalidated()
 	{
-		invalidated_resources.remove_if([&](auto &rtt)
+		remove_invalidated_if([&](auto &rtt)
 		{
 			if (rtt->deref_count >= 2)
 				return true;
@@ -268,6 +268,7 @@ gl::vertex_upload_info GLGSRender::set_vertex_buffer()
 
 	std::chrono::time_point<steady_clock> now = steady_clock::now();
 	m_vertex_upload_time += std::chrono::duration_cast<std::chrono::microseconds>(now - then).count();
+	performance_counters.frontend.vertex_upload_time += std::chrono::duration_cast<std::chrono::nanoseconds>(now - then).count();
 	return upload_info;
 }
 
@@ -1,6 +1,8 @@
 #include "stdafx.h"
 #include "NullGSRender.h"
 #include "Emu/System.h"
+#include "Emu/RSX/rsx_methods.h"
+#include "Emu/RSX/Common/BufferUtils.h"
 
 NullGSRender::NullGSRender() : GSRender()
 {
@@ -10,3 +12,84 @@ bool NullGSRender::do_method(u32 cmd, u32 value)
 {
 	return false;
 }
+
+void NullGSRender::end()
+{
+	if (performance_counters.detailed && !skip_frame)
+	{
+		// Run the backend-independent part of the vertex upload, so the frontend can be measured without a GPU
+		const auto vertex_start = steady_clock::now();
+		upload_vertex_data();
+		performance_counters.frontend.vertex_upload_time += std::chrono::duration_cast<std::chrono::nanoseconds>(steady_clock::now() - vertex_start).count();
+	}
+
+	rsx::thread::end();
+}
+
+void NullGSRender::upload_vertex_data()
+{
+	const auto& clause = rsx::method_registers.current_draw_clause;
+
+	if (clause.command == rsx::draw_command::none || clause.first_count_commands.empty())
+	{
+		return;
+	}
+
+	const auto layout = analyse_inputs_interleaved();
+
+	u32 vertex_base = 0;
+	u32 vertex_count = 0;
+
+	switch (clause.command)
+	{
+	case rsx::draw_command::array:
+	{
+		vertex_base = clause.first_count_commands.front().first;
+		vertex_count = clause.get_elements_count();
+		break;
+	}
+	case rsx::draw_command::indexed:
+	{
+		const auto type = clause.is_immediate_draw ? rsx::index_array_type::u32 : rsx::method_registers.index_type();
+		const u32 index_count = clause.get_elements_count();
+		const auto command = get_draw_command(rsx::method_registers);
+
+		m_index_scratch.resize(index_count * get_index_type_size(type));
+
+		u32 min_index, max_index;
+		std::tie(min_index, max_index, std::ignore) = write_index_array_data_to_buffer({ reinterpret_cast<gsl::byte*>(m_index_scratch.data()), ::size32(m_index_scratch) },
+			command.get<rsx::draw_indexed_array_command>().raw_index_buffer, type, clause.primitive, rsx::method_registers.restart_index_enabled(), rsx::method_registers.restart_index(),
+			clause.first_count_commands, rsx::method_registers.vertex_data_base_index(), [](auto) { return false; });
+
+		// Empty index set (a single vertex has min_index == max_index)
+		if (min_index > max_index)
+		{
+			return;
+		}
+
+		vertex_base = min_index;
+		vertex_count = max_index - min_index + 1;
+		break;
+	}
+	case rsx::draw_command::inlined_array:
+	{
+		if (layout.interleaved_blocks.empty() || !layout.interleaved_blocks[0].attribute_stride)
+		{
+			return;
+		}
+
+		vertex_count = ::size32(clause.inline_vertex_array) * sizeof(u32) / layout.interleaved_blocks[0].attribute_stride;
+		break;
+	}
+	default:
+	{
+		return;
+	}
+	}
+
+	const auto required = calculate_memory_requirements(layout, vertex_count);
+
+	m_vertex_scratch.resize(required.first + required.second);
+
+	write_vertex_data_to_memory(layout, vertex_base, vertex_count, m_vertex_scratch.data(), m_vertex_scratch.data() + required.first);
+}
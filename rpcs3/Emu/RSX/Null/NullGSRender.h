@@ -3,9 +3,16 @@
 
 class NullGSRender final : public GSRender
 {
+	// Host scratch memory for the frontend upload path (detailed mode)
+	std::vector<u8> m_index_scratch;
+	std::vector<u8> m_vertex_scratch;
+
 public:
 	NullGSRender();
 
 private:
 	bool do_method(u32 cmd, u32 value) override;
+	void end() override;
+
+	void upload_vertex_data();
 };
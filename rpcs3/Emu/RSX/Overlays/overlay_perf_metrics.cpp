@@ -201,6 +201,8 @@ namespace rsx
 				f32 spu_usage{0};
 				f32 rsx_usage{0};
 				u32 rsx_load{0};
+				u32 texture_memory{0};
+				u32 texture_evictions{0};
 
 				std::shared_ptr<GSRender> rsx_thread;
 
@@ -215,6 +217,8 @@ namespace rsx
 
 					rsx_thread = fxm::get<GSRender>();
 					rsx_load = rsx_thread->get_load();
+					texture_memory = rsx_thread->performance_counters.texture_memory / 0x100000;
+					texture_evictions = rsx_thread->performance_counters.texture_evictions;
 
 					total_threads = CPUStats::get_thread_count();
 
@@ -290,8 +294,10 @@ namespace rsx
 					                         " RSX   : %04.1f %% ( 1)\n"
 					                         " Total : %04.1f %% (%2u)\n\n"
 					                         "%s\n"
-					                         " RSX   : %02u %%",
-					    fps, frametime, std::string(title1_high.size(), ' '), ppu_usage, ppus, spu_usage, spus + rawspus, rsx_usage, cpu_usage, total_threads, std::string(title2.size(), ' '), rsx_load);
+					                         " RSX   : %02u %%\n"
+					                         " TEX   : %u MB (%u evicted)",
+					    fps, frametime, std::string(title1_high.size(), ' '), ppu_usage, ppus, spu_usage, spus + rawspus, rsx_usage, cpu_usage, total_threads, std::string(title2.size(), ' '), rsx_load,
+					    texture_memory, texture_evictions);
 					break;
 				}
 				}
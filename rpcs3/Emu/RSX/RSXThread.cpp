@@ -329,6 +329,7 @@ namespace rsx
 			capture::capture_draw_memory(this);
 
 		in_begin_end = false;
+		performance_counters.frontend.draw_calls++;
 
 		for (u8 index = 0; index < rsx::limits::vertex_count; ++index)
 		{
@@ -421,6 +422,7 @@ namespace rsx
 
 		// Raise priority above other threads
 		thread_ctrl::set_native_priority(1);
+		thread_ctrl::set_class(thread_class::rsx);
 
 		if (g_cfg.core.thread_scheduler_enabled)
 		{
@@ -920,7 +922,18 @@ namespace rsx
 					}
 				}
 
-				method_registers.decode(reg, value);
+				performance_counters.frontend.fifo_commands++;
+
+				if (UNLIKELY(performance_counters.detailed))
+				{
+					const auto decode_start = steady_clock::now();
+					method_registers.decode(reg, value);
+					performance_counters.frontend.decode_time += std::chrono::duration_cast<std::chrono::nanoseconds>(steady_clock::now() - decode_start).count();
+				}
+				else
+				{
+					method_registers.decode(reg, value);
+				}
 
 				if (execute_method_call)
 				{
@@ -937,6 +950,12 @@ namespace rsx
 				}
 			}
 
+			if (capture_current_frame)
+			{
+				// Write out completed commands
+				capture::flush_capture_commands();
+			}
+
 			if (unaligned_command && invalid_command_interrupt_raised)
 			{
 				//This is almost guaranteed to be heap corruption at this point
@@ -2258,6 +2277,13 @@ namespace rsx
 		}
 
 		performance_counters.sampled_frames++;
+
+		// Record flip time and publish frontend statistics (read by benchmark mode)
+		writer_lock lock(performance_counters.flip_mutex);
+		const u64 flip_index = performance_counters.flip_count;
+		performance_counters.flip_times[flip_index % performance_counters.flip_times.size()] = get_system_time();
+		performance_counters.flip_count = flip_index + 1;
+		performance_counters.frontend_flip = performance_counters.frontend;
 	}
 
 	void thread::check_zcull_status(bool framebuffer_swap)
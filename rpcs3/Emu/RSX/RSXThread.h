@@ -90,6 +90,16 @@ namespace rsx
 		lock_wait = 4 // Puller is processing a lock acquire
 	};
 
+	// Cumulative frontend statistics (written by RSX thread only)
+	struct frontend_stats
+	{
+		u64 fifo_commands = 0;      // Method register writes
+		u64 draw_calls = 0;
+		u64 decode_time = 0;        // Time in method_registers.decode (ns, detailed mode only)
+		u64 vertex_upload_time = 0; // Vertex and index upload (ns)
+		u64 texture_time = 0;       // Texture cache lookups (ns)
+	};
+
 	u32 get_vertex_type_size_on_host(vertex_base_type type, u32 size);
 
 	u32 get_address(u32 offset, u32 location);
@@ -317,6 +327,14 @@ namespace rsx
 			FIFO_state state = FIFO_state::running;
 			u32 approximate_load = 0;
 			u32 sampled_frames = 0;
+			atomic_t<u64> flip_count{ 0 };      // Total number of flips
+			std::array<u64, 1024> flip_times{}; // Timestamps of recent flips (indexed by flip_count)
+			frontend_stats frontend;            // Updated by RSX thread only
+			frontend_stats frontend_flip;       // Copy of frontend made on flip (for other threads)
+			shared_mutex flip_mutex;            // Protects flip_count, flip_times and frontend_flip
+			bool detailed = false; // Measure decode time for every method (expensive)
+			u32 texture_memory = 0;    // Texture cache memory in use (bytes, updated on flip)
+			u32 texture_evictions = 0; // Texture cache sections evicted to stay within the memory budget
 		}
 		performance_counters;
 
@@ -1071,6 +1071,7 @@ void VKGSRender::end()
 	auto upload_info = upload_vertex_data();
 	std::chrono::time_point<steady_clock> vertex_end = steady_clock::now();
 	m_vertex_upload_time += std::chrono::duration_cast<std::chrono::microseconds>(vertex_end - vertex_start).count();
+	performance_counters.frontend.vertex_upload_time += std::chrono::duration_cast<std::chrono::nanoseconds>(vertex_end - vertex_start).count();
 
 	std::chrono::time_point<steady_clock> textures_start = vertex_end;
 
@@ -1302,6 +1303,7 @@ void VKGSRender::end()
 
 	std::chrono::time_point<steady_clock> textures_end = steady_clock::now();
 	m_textures_upload_time += (u32)std::chrono::duration_cast<std::chrono::microseconds>(textures_end - textures_start).count();
+	performance_counters.frontend.texture_time += std::chrono::duration_cast<std::chrono::nanoseconds>(textures_end - textures_start).count();
 
 	//Load program
 	std::chrono::time_point<steady_clock> program_start = textures_end;
@@ -1609,6 +1611,13 @@ void VKGSRender::on_init_thread()
 void VKGSRender::on_exit()
 {
 	zcull_ctrl.release();
+
+	if (m_shaders_cache)
+	{
+		// Write pending pipelines
+		m_shaders_cache->flush();
+	}
+
 	return GSRender::on_exit();
 }
 
@@ -1896,8 +1905,12 @@ void VKGSRender::advance_queued_frames()
 
 	//texture cache is also double buffered to prevent use-after-free
 	m_texture_cache.on_frame_end();
+	m_texture_cache.enforce_memory_budget();
 	m_samplers_dirty.store(true);
 
+	performance_counters.texture_memory = m_texture_cache.get_texture_memory_in_use();
+	performance_counters.texture_evictions = m_texture_cache.get_num_evictions();
+
 	//Remove stale framebuffers. Ref counted to prevent use-after-free
 	m_framebuffers_to_clean.remove_if([](std::unique_ptr<vk::framebuffer_holder>& fbo)
 	{
@@ -3245,7 +3258,7 @@ void VKGSRender::flip(int buffer)
 			const auto num_mispredict = m_texture_cache.get_num_cache_mispredictions();
 			const auto cache_miss_ratio = (u32)ceil(m_texture_cache.get_cache_miss_ratio() * 100);
 			m_text_writer->print_text(*m_current_command_buffer, *direct_fbo, 0, 144, direct_fbo->width(), direct_fbo->height(), "Unreleased textures: " + std::to_string(num_dirty_textures));
-			m_text_writer->print_text(*m_current_command_buffer, *direct_fbo, 0, 162, direct_fbo->width(), direct_fbo->height(), "Texture cache memory: " + std::to_string(texture_memory_size) + "M");
+			m_text_writer->print_text(*m_current_command_buffer, *direct_fbo, 0, 162, direct_fbo->width(), direct_fbo->height(), fmt::format("Texture cache memory: %dM (%d evicted)", texture_memory_size, m_texture_cache.get_num_evictions()));
 			m_text_writer->print_text(*m_current_command_buffer, *direct_fbo, 0, 180, direct_fbo->width(), direct_fbo->height(), "Temporary texture memory: " + std::to_string(tmp_texture_memory_size) + "M");
 			m_text_writer->print_text(*m_current_command_buffer, *direct_fbo, 0, 198, direct_fbo->width(), direct_fbo->height(), fmt::format("Flush requests: %d (%d%% hard faults, %d mispredictions)", num_flushes, cache_miss_ratio, num_mispredict));
 		}
@@ -334,13 +334,14 @@ namespace rsx
 		{
 			m_render_targets_storage.clear();
 			m_depth_stencil_storage.clear();
-			invalidated_resources.clear();
+			m_invalidated_pool.clear();
+			m_surface_info.clear();
 		}
 
 		void free_invalidated()
 		{
 			const u64 last_finished_frame = vk::get_last_completed_frame_id();
-			invalidated_resources.remove_if([&](std::unique_ptr<vk::render_target> &rtt)
+			remove_invalidated_if([&](std::unique_ptr<vk::render_target> &rtt)
 			{
 				verify(HERE), rtt->frame_tag != 0;
 
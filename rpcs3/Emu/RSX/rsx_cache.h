@@ -9,6 +9,8 @@
 
 #include "rsx_utils.h"
 #include <thread>
+#include <mutex>
+#include <condition_variable>
 
 namespace rsx
 {
@@ -393,6 +395,15 @@ namespace rsx
 			pipeline_storage_type pipeline_properties;
 		};
 
+		// Pipeline entry waiting to be written by the background writer (packed and hashed by the writer)
+		struct pending_entry
+		{
+			pipeline_storage_type pipeline;
+			RSXVertexProgram vp;
+			RSXFragmentProgram fp; // addr is invalid, ucode is stored in fp_data
+			std::vector<u8> fp_data;
+		};
+
 		std::string version_prefix;
 		std::string root_path;
 		std::string pipeline_class_name;
@@ -400,6 +411,131 @@ namespace rsx
 
 		backend_storage& m_storage;
 
+		// Background writer state
+		static constexpr std::size_t s_writer_batch_size = 64; // Entries which trigger immediate write
+		static constexpr std::size_t s_writer_max_pending = 1024; // Queue limit (store() waits for the writer)
+
+		std::thread m_writer;
+		std::mutex m_writer_mutex;
+		std::condition_variable m_writer_cv; // Signaled for the writer
+		std::condition_variable m_writer_done_cv; // Signaled when a batch is written
+		std::vector<pending_entry> m_pending;
+		bool m_writing = false;
+		bool m_flush_requested = false;
+		bool m_writer_exit = false;
+
+		// Write file via temporary file, so it never appears partially written under its final name
+		static bool write_file(const std::string& path, const void* data, std::size_t size)
+		{
+			const std::string tmp_path = path + ".tmp";
+
+			fs::file f(tmp_path, fs::rewrite);
+
+			if (!f || f.write(data, size) != size)
+			{
+				LOG_ERROR(RSX, "shader cache: failed to write %s (%s)", tmp_path, fs::g_tls_error);
+				f.close();
+				fs::remove_file(tmp_path);
+				return false;
+			}
+
+			f.close();
+
+			if (!fs::rename(tmp_path, path, true))
+			{
+				LOG_ERROR(RSX, "shader cache: failed to rename %s (%s)", tmp_path, fs::g_tls_error);
+				fs::remove_file(tmp_path);
+				return false;
+			}
+
+			return true;
+		}
+
+		void write_entry(pending_entry& entry)
+		{
+			entry.fp.addr = entry.fp_data.data();
+
+			const pipeline_data data = pack(entry.pipeline, entry.vp, entry.fp);
+
+			// Raw programs must be written before the pipeline which references them
+			static_assert(fmt::check_format<u64>("%llX.fp") && fmt::check_format<u64>("%llX.vp"), "");
+			char name[24];
+			std::string fp_name = root_path + "/raw/";
+			std::string vp_name = fp_name;
+			fp_name.append(name, fmt::format_to(name, "%llX.fp", data.fragment_program_hash));
+			vp_name.append(name, fmt::format_to(name, "%llX.vp", data.vertex_program_hash));
+
+			if (!fs::is_file(fp_name) && !write_file(fp_name, entry.fp_data.data(), entry.fp_data.size()))
+			{
+				return;
+			}
+
+			if (!fs::is_file(vp_name) && !write_file(vp_name, entry.vp.data.data(), entry.vp.data.size() * sizeof(u32)))
+			{
+				return;
+			}
+
+			u64 state_hash = 0;
+			state_hash ^= rpcs3::hash_base<u32>(data.vp_ctrl);
+			state_hash ^= rpcs3::hash_base<u32>(data.fp_ctrl);
+			state_hash ^= rpcs3::hash_base<u32>(data.fp_texture_dimensions);
+			state_hash ^= rpcs3::hash_base<u16>(data.fp_unnormalized_coords);
+			state_hash ^= rpcs3::hash_base<u16>(data.fp_height);
+			state_hash ^= rpcs3::hash_base<u16>(data.fp_pixel_layout);
+			state_hash ^= rpcs3::hash_base<u16>(data.fp_lighting_flags);
+			state_hash ^= rpcs3::hash_base<u16>(data.fp_shadow_textures);
+			state_hash ^= rpcs3::hash_base<u16>(data.fp_redirected_textures);
+			state_hash ^= rpcs3::hash_base<u16>(data.fp_alphakill_mask);
+			state_hash ^= rpcs3::hash_base<u64>(data.fp_zfunc_mask);
+
+			static_assert(fmt::check_format<u64, u64, u64, u64>("%llX+%llX+%llX+%llX.bin"), "");
+			char pipeline_file_name[80];
+			std::string pipeline_path = root_path + "/pipelines/" + pipeline_class_name + "/" + version_prefix + "/";
+			pipeline_path.append(pipeline_file_name, fmt::format_to(pipeline_file_name, "%llX+%llX+%llX+%llX.bin", data.vertex_program_hash, data.fragment_program_hash, data.pipeline_storage_hash, state_hash));
+			write_file(pipeline_path, &data, sizeof(pipeline_data));
+		}
+
+		void writer_loop()
+		{
+			std::unique_lock<std::mutex> lock(m_writer_mutex);
+
+			while (true)
+			{
+				// Collect a batch (write whatever is pending at least once per second)
+				m_writer_cv.wait_for(lock, 1s, [&]
+				{
+					return m_writer_exit || m_flush_requested || m_pending.size() >= s_writer_batch_size;
+				});
+
+				if (m_pending.empty())
+				{
+					m_flush_requested = false;
+					m_writer_done_cv.notify_all();
+
+					if (m_writer_exit)
+					{
+						break;
+					}
+
+					continue;
+				}
+
+				std::vector<pending_entry> batch;
+				batch.swap(m_pending);
+				m_writing = true;
+				lock.unlock();
+
+				for (auto& entry : batch)
+				{
+					write_entry(entry);
+				}
+
+				lock.lock();
+				m_writing = false;
+				m_writer_done_cv.notify_all();
+			}
+		}
+
 	public:
 
 		struct progress_dialog_helper
@@ -474,6 +610,21 @@ namespace rsx
 			root_path = Emu.GetCachePath() + "/shaders_cache";
 		}
 
+		~shaders_cache()
+		{
+			if (m_writer.joinable())
+			{
+				{
+					std::lock_guard<std::mutex> lock(m_writer_mutex);
+					m_writer_exit = true;
+				}
+
+				// Pending entries are written before the writer exits
+				m_writer_cv.notify_one();
+				m_writer.join();
+			}
+		}
+
 		template <typename... Args>
 		void load(progress_dialog_helper* dlg, Args&& ...args)
 		{
@@ -503,6 +654,13 @@ namespace rsx
 				if (tmp.name == "." || tmp.name == "..")
 					continue;
 
+				if (tmp.name.size() > 4 && tmp.name.compare(tmp.name.size() - 4, 4, ".tmp") == 0)
+				{
+					// Leftover of interrupted write
+					fs::remove_file(directory_path + "/" + tmp.name);
+					continue;
+				}
+
 				entries.push_back(tmp);
 			}
 
@@ -646,6 +804,7 @@ namespace rsx
 			dlg->close();
 		}
 
+		// Queue pipeline for writing (files are written by the background writer in batches)
 		void store(pipeline_storage_type &pipeline, RSXVertexProgram &vp, RSXFragmentProgram &fp)
 		{
 			if (g_cfg.video.disable_on_disk_shader_cache || Emu.GetCachePath() == "")
@@ -653,45 +812,60 @@ namespace rsx
 				return;
 			}
 
-			pipeline_data data = pack(pipeline, vp, fp);
-			std::string fp_name = root_path + "/raw/" + fmt::format("%llX.fp", data.fragment_program_hash);
-			std::string vp_name = root_path + "/raw/" + fmt::format("%llX.vp", data.vertex_program_hash);
+			// Only copy the programs here, fragment program ucode is read from guest memory
+			pending_entry entry;
+			entry.pipeline = pipeline;
+			entry.vp = vp;
+			entry.fp = fp;
+
+			const auto size = program_hash_util::fragment_program_utils::get_fragment_program_ucode_size(fp.addr);
+			entry.fp_data.assign(static_cast<const u8*>(fp.addr), static_cast<const u8*>(fp.addr) + size);
+			entry.fp.addr = nullptr;
 
-			if (!fs::is_file(fp_name))
+			std::unique_lock<std::mutex> lock(m_writer_mutex);
+
+			if (!m_writer.joinable())
 			{
-				const auto size = program_hash_util::fragment_program_utils::get_fragment_program_ucode_size(fp.addr);
-				fs::file(fp_name, fs::rewrite).write(fp.addr, size);
+				m_writer = std::thread([this] { writer_loop(); });
 			}
 
-			if (!fs::is_file(vp_name))
+			if (m_pending.size() >= s_writer_max_pending)
 			{
-				fs::file(vp_name, fs::rewrite).write<u32>(vp.data);
+				m_writer_cv.notify_one();
+				m_writer_done_cv.wait(lock, [&] { return m_pending.size() < s_writer_max_pending; });
 			}
 
-			u64 state_hash = 0;
-			state_hash ^= rpcs3::hash_base<u32>(data.vp_ctrl);
-			state_hash ^= rpcs3::hash_base<u32>(data.fp_ctrl);
-			state_hash ^= rpcs3::hash_base<u32>(data.fp_texture_dimensions);
-			state_hash ^= rpcs3::hash_base<u16>(data.fp_unnormalized_coords);
-			state_hash ^= rpcs3::hash_base<u16>(data.fp_height);
-			state_hash ^= rpcs3::hash_base<u16>(data.fp_pixel_layout);
-			state_hash ^= rpcs3::hash_base<u16>(data.fp_lighting_flags);
-			state_hash ^= rpcs3::hash_base<u16>(data.fp_shadow_textures);
-			state_hash ^= rpcs3::hash_base<u16>(data.fp_redirected_textures);
-			state_hash ^= rpcs3::hash_base<u16>(data.fp_alphakill_mask);
-			state_hash ^= rpcs3::hash_base<u64>(data.fp_zfunc_mask);
+			m_pending.emplace_back(std::move(entry));
+
+			if (m_pending.size() >= s_writer_batch_size)
+			{
+				m_writer_cv.notify_one();
+			}
+		}
+
+		// Wait until all queued pipelines are written
+		void flush()
+		{
+			std::unique_lock<std::mutex> lock(m_writer_mutex);
+
+			if (!m_writer.joinable())
+			{
+				return;
+			}
 
-			std::string pipeline_file_name = fmt::format("%llX+%llX+%llX+%llX.bin", data.vertex_program_hash, data.fragment_program_hash, data.pipeline_storage_hash, state_hash);
-			std::string pipeline_path = root_path + "/pipelines/" + pipeline_class_name + "/" + version_prefix + "/" + pipeline_file_name;
-			fs::file(pipeline_path, fs::rewrite).write(&data, sizeof(pipeline_data));
+			m_flush_requested = true;
+			m_writer_cv.notify_one();
+			m_writer_done_cv.wait(lock, [&] { return m_pending.empty() && !m_writing; });
 		}
 
 		RSXVertexProgram load_vp_raw(u64 program_hash)
 		{
 			std::vector<u32> data;
-			std::string filename = fmt::format("%llX.vp", program_hash);
+			char filename[24];
+			std::string path = root_path + "/raw/";
+			path.append(filename, fmt::format_to(filename, "%llX.vp", program_hash));
 
-			fs::file f(root_path + "/raw/" + filename);
+			fs::file f(path);
 			f.read<u32>(data, f.size() / sizeof(u32));
 
 			RSXVertexProgram vp = {};
@@ -704,9 +878,11 @@ namespace rsx
 		RSXFragmentProgram load_fp_raw(u64 program_hash)
 		{
 			std::vector<u8> data;
-			std::string filename = fmt::format("%llX.fp", program_hash);
+			char filename[24];
+			std::string path = root_path + "/raw/";
+			path.append(filename, fmt::format_to(filename, "%llX.fp", program_hash));
 
-			fs::file f(root_path + "/raw/" + filename);
+			fs::file f(path);
 			f.read<u8>(data, f.size());
 
 			RSXFragmentProgram fp = {};
@@ -9,9 +9,6 @@
 #include "Emu/Cell/lv2/sys_rsx.h"
 #include "Capture/rsx_capture.h"
 
-#include <sstream>
-#include <cereal/archives/binary.hpp>
-
 #include <thread>
 
 template <>
@@ -127,6 +124,7 @@ namespace rsx
 
 			if (addr >> 28 != 0x4)
 			{
+				vm::reservation_wake(addr);
 				vm::reservation_notifier(addr, 4).notify_all();
 			}
 		}
@@ -1024,34 +1022,38 @@ namespace rsx
 		}
 		else if (user_asked_for_frame_capture && !rsx->capture_current_frame)
 		{
-			rsx->capture_current_frame = true;
 			user_asked_for_frame_capture = false;
-			frame_debug.reset();
-			frame_capture.reset();
-
-			// random number just to jumpstart the size
-			frame_capture.replay_commands.reserve(8000);
 
-			// capture first tile state with nop cmd
-			rsx::frame_capture_data::replay_command replay_cmd;
-			replay_cmd.rsx_command = std::make_pair(NV4097_NO_OPERATION, 0);
-			frame_capture.replay_commands.push_back(replay_cmd);
-			capture::capture_display_tile_state(rsx, frame_capture.replay_commands.back());
+			// todo: 'dynamicly' create capture filename
+			if (capture::begin_capture_file(fs::get_config_dir() + "capture.rrc"))
+			{
+				rsx->capture_current_frame = true;
+				frame_debug.reset();
+				frame_capture.reset();
+
+				// random number just to jumpstart the size
+				frame_capture.replay_commands.reserve(8000);
+
+				// capture first tile state with nop cmd
+				rsx::frame_capture_data::replay_command replay_cmd;
+				replay_cmd.rsx_command = std::make_pair(NV4097_NO_OPERATION, 0);
+				frame_capture.replay_commands.push_back(replay_cmd);
+				capture::capture_display_tile_state(rsx, frame_capture.replay_commands.back());
+			}
 		}
 		else if (rsx->capture_current_frame)
 		{
 			rsx->capture_current_frame = false;
-			std::stringstream os;
-			cereal::BinaryOutputArchive archive(os);
 			const std::string& filePath = fs::get_config_dir() + "capture.rrc";
-			archive(frame_capture);
+
+			if (capture::end_capture_file())
 			{
-				// todo: 'dynamicly' create capture filename, also may want to compress this data?
-				fs::file f(filePath, fs::rewrite);
-				f.write(os.str());
+				LOG_SUCCESS(RSX, "capture successful: %s", filePath.c_str());
+			}
+			else
+			{
+				LOG_ERROR(RSX, "capture failed: %s", filePath.c_str());
 			}
-
-			LOG_SUCCESS(RSX, "capture successful: %s", filePath.c_str());
 
 			frame_capture.reset();
 			Emu.Pause();
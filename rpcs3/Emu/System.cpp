@@ -15,6 +15,7 @@
 #include "Emu/Cell/lv2/sys_rsx.h"
 
 #include "Emu/IdManager.h"
+#include "Emu/Benchmark.h"
 #include "Emu/RSX/GSRender.h"
 #include "Emu/RSX/Capture/rsx_replay.h"
 
@@ -28,12 +29,9 @@
 #include "../Crypto/unpkg.h"
 #include <yaml-cpp/yaml.h>
 
-#include "cereal/archives/binary.hpp"
-
 #include <thread>
 #include <typeinfo>
 #include <queue>
-#include <fstream>
 #include <memory>
 
 #include "Utilities/GDBDebugServer.h"
@@ -399,31 +397,27 @@ void Emulator::Init()
 	}
 }
 
-bool Emulator::BootRsxCapture(const std::string& path)
+bool Emulator::BootRsxCapture(const std::string& path, u32 loops)
 {
 	if (!fs::is_file(path))
 		return false;
 
-	std::fstream f(path, std::ios::in | std::ios::binary);
-
-	cereal::BinaryInputArchive archive(f);
-	std::unique_ptr<rsx::frame_capture_data> frame = std::make_unique<rsx::frame_capture_data>();
-	archive(*frame);
+	std::unique_ptr<rsx::frame_capture_data> frame = rsx::load_frame_capture(path);
 
-	if (frame->magic != rsx::FRAME_CAPTURE_MAGIC)
+	if (!frame)
 	{
-		LOG_ERROR(LOADER, "Invalid rsx capture file!");
 		return false;
 	}
 
-	if (frame->version != rsx::FRAME_CAPTURE_VERSION)
+	Init();
+
+	// Apply config override (command line)
+	if (!cfg_override.empty())
 	{
-		LOG_ERROR(LOADER, "Rsx capture file version not supported! Expected %d, found %d", rsx::FRAME_CAPTURE_VERSION, frame->version);
-		return false;
+		LOG_NOTICE(LOADER, "Applying config override:\n%s", cfg_override);
+		g_cfg.from_string(cfg_override);
 	}
 
-	Init();
-
 	vm::init();
 
 	// PS3 'executable'
@@ -437,7 +431,7 @@ bool Emulator::BootRsxCapture(const std::string& path)
 	GetCallbacks().on_run();
 	m_state = system_state::running;
 
-	auto&& rsxcapture = idm::make_ptr<ppu_thread, rsx::rsx_replay_thread>(std::move(frame));
+	auto&& rsxcapture = idm::make_ptr<ppu_thread, rsx::rsx_replay_thread>(std::move(frame), loops);
 	rsxcapture->run();
 
 	return true;
@@ -550,6 +544,9 @@ void Emulator::Load(bool add_only)
 	{
 		Init();
 
+		// Reset JIT statistics
+		g_jit_counters.reset();
+
 		// Load game list (maps ABCD12345 IDs to /dev_bdvd/ locations)
 		YAML::Node games = YAML::Load(fs::file{fs::get_config_dir() + "/games.yml", fs::read + fs::create}.to_string());
 
@@ -653,6 +650,13 @@ void Emulator::Load(bool add_only)
 			g_cfg.from_string(cfg_file.to_string());
 		}
 
+		// Apply config override (command line)
+		if (!cfg_override.empty())
+		{
+			LOG_NOTICE(LOADER, "Applying config override:\n%s", cfg_override);
+			g_cfg.from_string(cfg_override);
+		}
+
 #if defined(_WIN32) || defined(HAVE_VULKAN)
 		if (g_cfg.video.renderer == video_renderer::vulkan)
 		{
@@ -37,6 +37,13 @@ enum class spu_block_size_type
 	giga,
 };
 
+enum class llvm_opt_level
+{
+	fast, // Minimal set of passes
+	balanced,
+	aggressive,
+};
+
 enum class lib_loading_type
 {
 	automatic,
@@ -246,6 +253,7 @@ public:
 	std::vector<u8> data;
 	std::vector<u8> klic;
 	std::string disc;
+	std::string cfg_override; // Config (YAML) applied on top of the custom configs
 
 	const std::string& GetBoot() const
 	{
@@ -283,7 +291,7 @@ public:
 	}
 
 	bool BootGame(const std::string& path, bool direct = false, bool add_only = false);
-	bool BootRsxCapture(const std::string& path);
+	bool BootRsxCapture(const std::string& path, u32 loops = 0);
 	bool InstallPkg(const std::string& path);
 
 	static std::string GetEmuDir();
@@ -327,6 +335,10 @@ struct cfg_root : cfg::node
 		cfg::_bool llvm_logs{this, "Save LLVM logs"};
 		cfg::string llvm_cpu{this, "Use LLVM CPU"};
 		cfg::_int<0, INT32_MAX> llvm_threads{this, "Max LLVM Compile Threads", 0};
+		cfg::_enum<llvm_opt_level> llvm_opt{this, "LLVM Optimization Level", llvm_opt_level::fast}; // Function passes used by PPU and SPU LLVM recompilers
+		cfg::_int<0, 16> vdec_threads{this, "Video Decoder Threads", 0}; // FFmpeg decoding threads per cellVdec instance (0 = auto)
+		cfg::_bool ppu_lazy{this, "PPU LLVM Lazy Compilation", false}; // Interpret uncached code, compile hot module parts in background
+		cfg::_int<1, INT32_MAX> ppu_lazy_threshold{this, "PPU LLVM Lazy Threshold", 100}; // Function entries before compilation
 		cfg::_bool thread_scheduler_enabled{this, "Enable thread scheduler", thread_scheduler_enabled_def};
 		cfg::_bool set_daz_and_ftz{this, "Set DAZ and FTZ", false};
 		cfg::_enum<spu_decoder_type> spu_decoder{this, "SPU Decoder", spu_decoder_type::asmjit};
@@ -341,6 +353,10 @@ struct cfg_root : cfg::node
 		cfg::_bool spu_accurate_putlluc{this, "Accurate PUTLLUC", false};
 		cfg::_bool spu_verification{this, "SPU Verification", true}; // Should be enabled
 		cfg::_bool spu_cache{this, "SPU Cache", true};
+		cfg::_bool spu_tiered{this, "SPU LLVM Tiered Compilation", false}; // Run new blocks with ASMJIT first, recompile hot blocks with LLVM in background
+		cfg::_int<1, INT32_MAX> spu_tier_threshold{this, "SPU LLVM Tier Threshold", 1000}; // Block executions before LLVM recompilation
+		cfg::_bool spu_profiler{this, "SPU Profiler", false}; // Count block executions (recompilers only)
+		cfg::_bool spu_profiler_cycles{this, "SPU Profiler Cycles", false}; // Also measure time spent in blocks (slow)
 		cfg::_enum<tsx_usage> enable_TSX{this, "Enable TSX", tsx_usage::enabled}; // Enable TSX. Forcing this on Haswell/Broadwell CPUs should be used carefully
 
 		cfg::_enum<lib_loading_type> lib_loading{this, "Lib Loader", lib_loading_type::liblv2only};
@@ -402,6 +418,7 @@ struct cfg_root : cfg::node
 		cfg::_int<0, 16> anisotropic_level_override{this, "Anisotropic Filter Override", 0};
 		cfg::_int<1, 1024> min_scalable_dimension{this, "Minimum Scalable Dimension", 16};
 		cfg::_int<0, 30000000> driver_recovery_timeout{this, "Driver Recovery Timeout", 1000000};
+		cfg::_int<0, 65536> texture_cache_budget{this, "Texture Cache Memory Budget (MB)", 0}; // 0 = unlimited
 
 		struct node_d3d12 : cfg::node
 		{
@@ -9,6 +9,9 @@
 
 #include "rpcs3_app.h"
 #include "Utilities/sema.h"
+#include "Utilities/StrUtil.h"
+#include "Emu/IdManager.h"
+#include "Emu/Benchmark.h"
 #ifdef _WIN32
 #include <windows.h>
 #endif
@@ -91,6 +94,14 @@ int main(int argc, char** argv)
 		std::fprintf(stderr, "Failed to set max open file limit (4096).");
 #endif
 
+	// Headless mode must be known before Qt initialization (no display is required)
+	const bool headless = std::any_of(argv + 1, argv + argc, [](const char* arg) { return std::strcmp(arg, "--headless") == 0; });
+
+	if (headless)
+	{
+		qputenv("QT_QPA_PLATFORM", "offscreen");
+	}
+
 	QCoreApplication::setAttribute(Qt::AA_UseHighDpiPixmaps);
 	QCoreApplication::setAttribute(Qt::AA_DisableWindowContextHelpButton);
 
@@ -104,9 +115,34 @@ int main(int argc, char** argv)
 	parser.addPositionalArgument("(S)ELF", "Path for directly executing a (S)ELF");
 	parser.addPositionalArgument("[Args...]", "Optional args for the executable");
 	parser.addHelpOption();
+
+	const QCommandLineOption headless_option("headless", "Run without GUI using Null renderer, audio and input.");
+	const QCommandLineOption benchmark_option("benchmark", "Write performance report (JSON) to <file> and exit.", "file");
+	const QCommandLineOption bench_time_option("bench-time", "Benchmark duration in seconds (default 60 if no flip limit is set).", "seconds");
+	const QCommandLineOption bench_flips_option("bench-flips", "Stop benchmark after <count> flips.", "count");
+	const QCommandLineOption replay_loops_option("replay-loops", "Replay RSX capture (.rrc) <count> times and exit.", "count");
+	parser.addOption(headless_option);
+	parser.addOption(benchmark_option);
+	parser.addOption(bench_time_option);
+	parser.addOption(bench_flips_option);
+	parser.addOption(replay_loops_option);
 	parser.parse(QCoreApplication::arguments());
 
-	app.Init();
+	app.Init(headless);
+
+	if (headless)
+	{
+		Emu.cfg_override =
+			"Video:\n  Renderer: Null\n"
+			"Audio:\n  Renderer: Null\n"
+			"Input/Output:\n  Keyboard: Null\n  Mouse: Null\n  Pad: Null\n";
+	}
+
+	// Benchmark settings
+	const std::string bench_path = sstr(parser.value(benchmark_option));
+	const u64 bench_flips = parser.value(bench_flips_option).toULongLong();
+	const u64 bench_time = parser.value(bench_time_option).toULongLong();
+	const u32 replay_loops = parser.value(replay_loops_option).toUInt();
 
 	QStringList args = parser.positionalArguments();
 
@@ -126,13 +162,37 @@ int main(int argc, char** argv)
 		}
 
 		// Ugly workaround
-		QTimer::singleShot(2, [path = sstr(QFileInfo(args.at(0)).canonicalFilePath()), argv = std::move(argv)]() mutable
+		QTimer::singleShot(2, [=, path = sstr(QFileInfo(args.at(0)).canonicalFilePath()), argv = std::move(argv)]() mutable
 		{
 			Emu.argv = std::move(argv);
 			Emu.SetForceBoot(true);
-			Emu.BootGame(path, true);
+
+			// RSX capture replay (frontend benchmark)
+			const bool is_capture = ends_with(fmt::to_lower(path), ".rrc");
+
+			if (is_capture ? !Emu.BootRsxCapture(path, replay_loops) : (!Emu.BootGame(path, true) || Emu.IsStopped()))
+			{
+				if (headless)
+				{
+					LOG_FATAL(GENERAL, "Failed to boot: %s", path);
+					Emu.GetCallbacks().exit();
+				}
+
+				return;
+			}
+
+			if (!bench_path.empty())
+			{
+				// Batch replay finishes the benchmark itself
+				fxm::make<benchmark_thread>(bench_path, bench_time || bench_flips || (is_capture && replay_loops) ? bench_time : 60, bench_flips);
+			}
 		});
 	}
+	else if (headless)
+	{
+		std::fprintf(stderr, "Headless mode requires an executable path.\n");
+		return 1;
+	}
 
 	s_qt_init.post();
 	s_qt_mutex.post();
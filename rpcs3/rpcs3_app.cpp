@@ -68,7 +68,7 @@ rpcs3_app::rpcs3_app(int& argc, char** argv) : QApplication(argc, argv)
 {
 }
 
-void rpcs3_app::Init()
+void rpcs3_app::Init(bool headless)
 {
 	setApplicationName("RPCS3");
 	setWindowIcon(QIcon(":/rpcs3.ico"));
@@ -78,6 +78,14 @@ void rpcs3_app::Init()
 	guiSettings.reset(new gui_settings());
 	emuSettings.reset(new emu_settings());
 
+	if (headless)
+	{
+		isHeadless = true;
+		InitializeCallbacks();
+		InitializeConnects();
+		return;
+	}
+
 	// Create the main window
 	RPCS3MainWin = new main_window(guiSettings, emuSettings, nullptr);
 
@@ -169,6 +177,12 @@ void rpcs3_app::InitializeCallbacks()
 
 	callbacks.get_gs_frame = [this]() -> std::unique_ptr<GSFrameBase>
 	{
+		if (isHeadless)
+		{
+			// Only usable with the Null renderer
+			return nullptr;
+		}
+
 		extern const std::unordered_map<video_resolution, std::pair<int, int>, value_hash<video_resolution>> g_video_out_resolution_map;
 
 		const auto size = g_video_out_resolution_map.at(g_cfg.video.resolution);
@@ -256,7 +270,7 @@ void rpcs3_app::InitializeCallbacks()
 
 	callbacks.get_msg_dialog = [=]() -> std::shared_ptr<MsgDialogBase>
 	{
-		return std::make_shared<msg_dialog_frame>(RPCS3MainWin->windowHandle());
+		return std::make_shared<msg_dialog_frame>(RPCS3MainWin ? RPCS3MainWin->windowHandle() : nullptr);
 	};
 
 	callbacks.get_save_dialog = [=]() -> std::unique_ptr<SaveDialogBase>
@@ -305,11 +319,16 @@ void rpcs3_app::InitializeCallbacks()
  */
 void rpcs3_app::InitializeConnects()
 {
-	connect(RPCS3MainWin, &main_window::RequestGlobalStylesheetChange, this, &rpcs3_app::OnChangeStyleSheetRequest);
-
 	qRegisterMetaType <std::function<void()>>("std::function<void()>");
 	connect(this, &rpcs3_app::RequestCallAfter, this, &rpcs3_app::HandleCallAfter);
 
+	if (!RPCS3MainWin)
+	{
+		return;
+	}
+
+	connect(RPCS3MainWin, &main_window::RequestGlobalStylesheetChange, this, &rpcs3_app::OnChangeStyleSheetRequest);
+
 	connect(this, &rpcs3_app::OnEmulatorRun, RPCS3MainWin, &main_window::OnEmuRun);
 	connect(this, &rpcs3_app::OnEmulatorStop, RPCS3MainWin, &main_window::OnEmuStop);
 	connect(this, &rpcs3_app::OnEmulatorPause, RPCS3MainWin, &main_window::OnEmuPause);
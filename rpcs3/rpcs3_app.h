@@ -32,8 +32,9 @@ class rpcs3_app : public QApplication
 public:
 	rpcs3_app(int& argc, char** argv);
 	/** Call this method before calling app.exec
+	 * In headless mode, the main window is not created and the emulator runs without a game window.
 	*/
-	void Init();
+	void Init(bool headless = false);
 Q_SIGNALS:
 	void OnEmulatorRun();
 	void OnEmulatorPause();
@@ -48,7 +49,9 @@ private:
 	void InitializeCallbacks();
 	void InitializeConnects();
 
-	main_window* RPCS3MainWin;
+	main_window* RPCS3MainWin = nullptr;
+
+	bool isHeadless = false;
 
 	std::shared_ptr<gui_settings> guiSettings;
 	std::shared_ptr<emu_settings> emuSettings;
@@ -1,6 +1,8 @@
 #include "debugger_frame.h"
 #include "qt_utils.h"
 
+#include "Emu/Cell/SPURecompiler.h"
+
 #include <QKeyEvent>
 #include <QScrollBar>
 #include <QApplication>
@@ -46,6 +48,7 @@ debugger_frame::debugger_frame(std::shared_ptr<gui_settings> settings, QWidget *
 	m_go_to_addr = new QPushButton(tr("Go To Address"), this);
 	m_go_to_pc = new QPushButton(tr("Go To PC"), this);
 	m_btn_capture = new QPushButton(tr("RSX Capture"), this);
+	m_btn_profile = new QPushButton(tr("SPU Profile"), this);
 	m_btn_step = new QPushButton(tr("Step"), this);
 	m_btn_step_over = new QPushButton(tr("Step Over"), this);
 	m_btn_run = new QPushButton(RunString, this);
@@ -57,6 +60,7 @@ debugger_frame::debugger_frame(std::shared_ptr<gui_settings> settings, QWidget *
 	hbox_b_main->addWidget(m_go_to_addr);
 	hbox_b_main->addWidget(m_go_to_pc);
 	hbox_b_main->addWidget(m_btn_capture);
+	hbox_b_main->addWidget(m_btn_profile);
 	hbox_b_main->addWidget(m_btn_step);
 	hbox_b_main->addWidget(m_btn_step_over);
 	hbox_b_main->addWidget(m_btn_run);
@@ -99,6 +103,15 @@ debugger_frame::debugger_frame(std::shared_ptr<gui_settings> settings, QWidget *
 		user_asked_for_frame_capture = true;
 	});
 
+	connect(m_btn_profile, &QAbstractButton::clicked, [=]()
+	{
+		// Write SPU block statistics collected so far
+		if (const auto profiler = fxm::get<spu_profiler>())
+		{
+			profiler->dump();
+		}
+	});
+
 	connect(m_btn_step, &QAbstractButton::clicked, this, &debugger_frame::DoStep);
 	connect(m_btn_step_over, &QAbstractButton::clicked, [=]() { DoStep(true); });
 
@@ -608,6 +621,7 @@ void debugger_frame::EnableButtons(bool enable)
 {
 	m_go_to_addr->setEnabled(enable);
 	m_go_to_pc->setEnabled(enable);
+	m_btn_profile->setEnabled(enable);
 	m_btn_step->setEnabled(enable);
 	m_btn_step_over->setEnabled(enable);
 	m_btn_run->setEnabled(enable);
@@ -39,6 +39,7 @@ class debugger_frame : public custom_dock_widget
 	QPushButton* m_go_to_addr;
 	QPushButton* m_go_to_pc;
 	QPushButton* m_btn_capture;
+	QPushButton* m_btn_profile;
 	QPushButton* m_btn_step;
 	QPushButton* m_btn_step_over;
 	QPushButton* m_btn_run;
@@ -29,48 +29,23 @@ memory_string_searcher::memory_string_searcher(QWidget* parent)
 
 void memory_string_searcher::OnSearch()
 {
-	const QString wstr = m_addr_line->text();
-	const char *str = wstr.toStdString().c_str();
-	const u32 len = wstr.length();
+	const std::string str = m_addr_line->text().toStdString();
+
+	if (str.empty())
+	{
+		return;
+	}
 
 	LOG_NOTICE(GENERAL, "Searching for string %s", str);
 
 	// Search the address space for the string
-	u32 strIndex = 0;
-	u32 numFound = 0;
 	const auto area = vm::get(vm::main);
-	for (u32 addr = area->addr; addr < area->addr + area->size; addr++)
-	{
-		if (!vm::check_addr(addr))
-		{
-			strIndex = 0;
-			continue;
-		}
+	const auto found = vm::search(area->addr, area->size, std::vector<u8>(str.begin(), str.end()));
 
-		u8 byte = vm::read8(addr);
-		if (byte == str[strIndex])
-		{
-			if (strIndex == len)
-			{
-				// Found it
-				LOG_NOTICE(GENERAL, "Found @ %04x", addr - len);
-				numFound++;
-				strIndex = 0;
-				continue;
-			}
-
-			strIndex++;
-		}
-		else
-		{
-			strIndex = 0;
-		}
-
-		if (addr % (1024 * 1024 * 64) == 0) // Log every 64mb
-		{
-			LOG_NOTICE(GENERAL, "Searching %04x ...", addr);
-		}
+	for (const u32 addr : found)
+	{
+		LOG_NOTICE(GENERAL, "Found @ %04x", addr);
 	}
 
-	LOG_NOTICE(GENERAL, "Search completed (found %d matches)", numFound);
+	LOG_NOTICE(GENERAL, "Search completed (found %d matches)", found.size());
 }